@@ -0,0 +1,219 @@
+#include "s21_band_matrix.h"
+
+S21BandMatrix::S21BandMatrix(int size, int lower, int upper)
+    : size_(size), lower_(lower), upper_(upper) {
+  if (size <= 0 || lower < 0 || upper < 0 || lower >= size ||
+      upper >= size) {
+    throw invalid_argument("Размер или ширина ленты не соответствуют");
+  }
+  data_.assign(static_cast<size_t>(size) * Width(), 0.0);
+}
+
+double S21BandMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+  return InBand(i, j) ? data_[Offset(i, j)] : 0.0;
+}
+
+double& S21BandMatrix::operator()(int i, int j) {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_ || !InBand(i, j)) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+  return data_[Offset(i, j)];
+}
+
+S21BandMatrix S21BandMatrix::FromMatrix(const S21Matrix& matrix, int lower,
+                                        int upper) {
+  if (matrix.rows_ != matrix.cols_) {
+    throw logic_error("Матрица не квадратная");
+  }
+
+  S21BandMatrix result(matrix.rows_, lower, upper);
+  for (int i = 0; i < result.size_; i++) {
+    const int first = max(0, i - lower);
+    const int last = min(result.size_ - 1, i + upper);
+    copy(matrix.Row(i) + first, matrix.Row(i) + last + 1,
+         result.data_.data() + result.Offset(i, first));
+  }
+  return result;
+}
+
+S21Matrix S21BandMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; i++) {
+    const int first = max(0, i - lower_);
+    const int last = min(size_ - 1, i + upper_);
+    copy(data_.data() + Offset(i, first), data_.data() + Offset(i, last) + 1,
+         result.Row(i) + first);
+  }
+  return result;
+}
+
+S21Matrix S21BandMatrix::Multiply(const S21Matrix& b) const {
+  if (b.rows_ != size_) {
+    throw invalid_argument(
+        "Столбцы в первой матрице не должны быть равными строкам во второй");
+  }
+
+  S21Matrix result(size_, b.cols_);
+  const size_t work = data_.size() * b.cols_;
+  S21ParallelFor(size_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* target = result.Row(i);
+      const int last = min(size_ - 1, i + upper_);
+      for (int j = max(0, i - lower_); j <= last; j++) {
+        const double aij = data_[Offset(i, j)];
+        const double* b_row = b.Row(j);
+        for (int c = 0; c < b.cols_; c++) target[c] += aij * b_row[c];
+      }
+    }
+  });
+  return result;
+}
+
+// Метод прогонки (алгоритм Томаса) на месте в x. Возвращает false, если
+// встретился нулевой ведущий элемент: тогда нужен выбор ведущего элемента
+bool S21BandMatrix::SolveTridiagonal(S21Matrix& x) const {
+  auto sub = [this](int i) {
+    return lower_ > 0 && i > 0 ? data_[Offset(i, i - 1)] : 0.0;
+  };
+  auto super = [this](int i) {
+    return upper_ > 0 && i + 1 < size_ ? data_[Offset(i, i + 1)] : 0.0;
+  };
+
+  // modified[i] — наддиагональный элемент строки i после исключения
+  vector<double> modified(size_);
+  for (int i = 0; i < size_; i++) {
+    double* row = x.Row(i);
+    double pivot = data_[Offset(i, i)];
+    if (i > 0) {
+      const double a = sub(i);
+      pivot -= a * modified[i - 1];
+      const double* previous = x.Row(i - 1);
+      for (int c = 0; c < x.cols_; c++) row[c] -= a * previous[c];
+    }
+    if (pivot == 0.0) return false;
+
+    const double inverse = 1.0 / pivot;
+    modified[i] = super(i) * inverse;
+    for (int c = 0; c < x.cols_; c++) row[c] *= inverse;
+  }
+
+  for (int i = size_ - 2; i >= 0; i--) {
+    double* row = x.Row(i);
+    const double* next = x.Row(i + 1);
+    for (int c = 0; c < x.cols_; c++) row[c] -= modified[i] * next[c];
+  }
+  return true;
+}
+
+// Ленточное LU с частичным выбором ведущего элемента, как в LAPACK dgbtrf.
+// Перестановки расширяют U до lower + upper наддиагоналей, поэтому строка
+// рабочего буфера занимает 2 lower + upper + 1 ячеек, элемент (i, j)
+// лежит в ячейке j - i + lower. Множители L остаются на месте шага, на
+// котором вычислены, и применяются к правой части в том же порядке
+bool S21BandMatrix::Factorize(vector<double>& lu, vector<int>& pivots) const {
+  const int band = lower_ + upper_;
+  const int width = lower_ + band + 1;
+  auto at = [&lu, width, this](int i, int j) -> double& {
+    return lu[static_cast<size_t>(i) * width + (j - i + lower_)];
+  };
+
+  lu.assign(static_cast<size_t>(size_) * width, 0.0);
+  pivots.resize(size_);
+  for (int i = 0; i < size_; i++) {
+    const int last = min(size_ - 1, i + upper_);
+    for (int j = max(0, i - lower_); j <= last; j++) {
+      at(i, j) = data_[Offset(i, j)];
+    }
+  }
+
+  for (int k = 0; k < size_; k++) {
+    const int last_row = min(size_ - 1, k + lower_);
+    const int last_col = min(size_ - 1, k + band);
+
+    int p = k;
+    for (int i = k + 1; i <= last_row; i++) {
+      if (fabs(at(i, k)) > fabs(at(p, k))) p = i;
+    }
+    pivots[k] = p;
+    if (at(p, k) == 0.0) return false;
+
+    if (p != k) {
+      for (int j = k; j <= last_col; j++) swap(at(k, j), at(p, j));
+    }
+
+    for (int i = k + 1; i <= last_row; i++) {
+      const double factor = at(i, k) /= at(k, k);
+      for (int j = k + 1; j <= last_col; j++) at(i, j) -= factor * at(k, j);
+    }
+  }
+  return true;
+}
+
+S21Matrix S21BandMatrix::Solve(const S21Matrix& b) const {
+  if (b.rows_ != size_ || b.cols_ <= 0) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+
+  S21Matrix x(b);
+  x.PrepareWrite();
+  if (lower_ <= 1 && upper_ <= 1 && SolveTridiagonal(x)) {
+    return x;
+  }
+
+  x = b;
+  x.PrepareWrite();
+  vector<double> lu;
+  vector<int> pivots;
+  if (!Factorize(lu, pivots)) {
+    throw logic_error("Матрица вырожденная, решения не сущестсвует");
+  }
+
+  const int band = lower_ + upper_;
+  const int width = lower_ + band + 1;
+  auto at = [&lu, width, this](int i, int j) {
+    return lu[static_cast<size_t>(i) * width + (j - i + lower_)];
+  };
+
+  for (int k = 0; k < size_; k++) {
+    if (pivots[k] != k) {
+      swap_ranges(x.Row(k), x.Row(k) + x.cols_, x.Row(pivots[k]));
+    }
+    const double* solved = x.Row(k);
+    const int last_row = min(size_ - 1, k + lower_);
+    for (int i = k + 1; i <= last_row; i++) {
+      const double factor = at(i, k);
+      double* row = x.Row(i);
+      for (int c = 0; c < x.cols_; c++) row[c] -= factor * solved[c];
+    }
+  }
+
+  for (int i = size_ - 1; i >= 0; i--) {
+    double* row = x.Row(i);
+    const int last_col = min(size_ - 1, i + band);
+    for (int j = i + 1; j <= last_col; j++) {
+      const double uij = at(i, j);
+      const double* next = x.Row(j);
+      for (int c = 0; c < x.cols_; c++) row[c] -= uij * next[c];
+    }
+    const double inverse = 1.0 / at(i, i);
+    for (int c = 0; c < x.cols_; c++) row[c] *= inverse;
+  }
+  return x;
+}
+
+double S21BandMatrix::Determinant() const {
+  vector<double> lu;
+  vector<int> pivots;
+  if (!Factorize(lu, pivots)) return 0.0;
+
+  const int width = 2 * lower_ + upper_ + 1;
+  double determinant = 1.0;
+  for (int k = 0; k < size_; k++) {
+    determinant *= lu[static_cast<size_t>(k) * width + lower_];
+    if (pivots[k] != k) determinant = -determinant;
+  }
+  return determinant;
+}
@@ -0,0 +1,52 @@
+#ifndef S21_BAND_MATRIX_H
+#define S21_BAND_MATRIX_H
+
+#include "s21_matrix_oop.h"
+
+// Ленточная матрица n x n с lower поддиагоналями и upper наддиагоналями.
+// Хранится по строкам: строка i занимает lower + upper + 1 ячеек, элемент
+// (i, j) лежит в ячейке j - i + lower
+class S21BandMatrix {
+ private:
+  int size_, lower_, upper_;
+  vector<double> data_;
+
+  int Width() const { return lower_ + upper_ + 1; }
+  bool InBand(int i, int j) const {
+    return j - i >= -lower_ && j - i <= upper_;
+  }
+  size_t Offset(int i, int j) const {
+    return static_cast<size_t>(i) * Width() + (j - i + lower_);
+  }
+
+  bool SolveTridiagonal(S21Matrix& x) const;
+  bool Factorize(vector<double>& lu, vector<int>& pivots) const;
+
+ public:
+  S21BandMatrix(int size, int lower, int upper);
+
+  int GetSize() const { return size_; }
+  int GetLower() const { return lower_; }
+  int GetUpper() const { return upper_; }
+
+  // Элементы вне ленты равны нулю и не могут быть изменены:
+  // неконстантный operator() для них бросает out_of_range
+  double operator()(int i, int j) const;
+  double& operator()(int i, int j);
+  double GetElement(int i, int j) const { return (*this)(i, j); }
+
+  // Преобразования; из S21Matrix берутся только элементы ленты
+  static S21BandMatrix FromMatrix(const S21Matrix& matrix, int lower,
+                                  int upper);
+  S21Matrix ToMatrix() const;
+
+  // this * b за O(n (lower + upper) b.cols)
+  S21Matrix Multiply(const S21Matrix& b) const;
+  // Трёхдиагональные системы решаются методом прогонки за O(n), остальные
+  // (и прогонка с нулевым ведущим элементом) — ленточным LU с выбором
+  // ведущего элемента за O(n lower (lower + upper))
+  S21Matrix Solve(const S21Matrix& b) const;
+  double Determinant() const;
+};
+
+#endif
@@ -0,0 +1,246 @@
+#include "s21_conjugate_gradient.h"
+
+namespace {
+
+double Dot(const vector<double>& x, const vector<double>& y) {
+  double sum = 0.0;
+  for (size_t i = 0; i < x.size(); i++) sum += x[i] * y[i];
+  return sum;
+}
+
+}  // namespace
+
+S21ConjugateGradient::S21ConjugateGradient(const S21Matrix& a,
+                                           Preconditioner preconditioner)
+    : S21ConjugateGradient(
+          a.GetRows(), [&a](span<const double> x, span<double> y) {
+            const size_t work = static_cast<size_t>(a.rows_) * a.cols_;
+            S21ParallelFor(a.rows_, work, [&](int begin, int end) {
+              for (int i = begin; i < end; i++) {
+                const double* row = a.Row(i);
+                double sum = 0.0;
+                for (int j = 0; j < a.cols_; j++) sum += row[j] * x[j];
+                y[i] = sum;
+              }
+            });
+          }) {
+  if (a.GetRows() != a.GetCols()) {
+    throw logic_error("Матрица не квадратная");
+  }
+  if (preconditioner != Preconditioner::kNone) {
+    SetMatrixPreconditioner(S21SparseMatrix::FromMatrix(a), preconditioner);
+  }
+}
+
+S21ConjugateGradient::S21ConjugateGradient(const S21SparseMatrix& a,
+                                           Preconditioner preconditioner)
+    : S21ConjugateGradient(a.GetRows(),
+                           [&a](span<const double> x, span<double> y) {
+                             a.MultiplyVector(x, y);
+                           }) {
+  if (a.GetRows() != a.GetCols()) {
+    throw logic_error("Матрица не квадратная");
+  }
+  SetMatrixPreconditioner(a, preconditioner);
+}
+
+S21ConjugateGradient::S21ConjugateGradient(int size, Operator apply)
+    : size_(size),
+      apply_(std::move(apply)),
+      tolerance_(1e-10),
+      max_iterations_(2 * size) {
+  if (size <= 0) {
+    throw invalid_argument("Размер системы не может быть меньше 0");
+  }
+  if (!apply_) {
+    throw invalid_argument("Оператор не задан");
+  }
+  x_.resize(size);
+  r_.resize(size);
+  z_.resize(size);
+  p_.resize(size);
+  q_.resize(size);
+}
+
+void S21ConjugateGradient::SetPreconditioner(Operator preconditioner) {
+  preconditioner_ = std::move(preconditioner);
+}
+
+void S21ConjugateGradient::SetTolerance(double tolerance) {
+  if (!(tolerance > 0.0)) {
+    throw invalid_argument("Точность должна быть больше 0");
+  }
+  tolerance_ = tolerance;
+}
+
+void S21ConjugateGradient::SetMaxIterations(int iterations) {
+  if (iterations <= 0) {
+    throw invalid_argument("Число итераций должно быть больше 0");
+  }
+  max_iterations_ = iterations;
+}
+
+// IC(0): L имеет те же ненулевые позиции, что нижний треугольник A.
+// Строки L считаются сверху вниз, L(i, k) выражается через скалярное
+// произведение уже готовых частей строк i и k (слияние списков столбцов).
+// Применение — прямая подстановка с L и обратная с L^T по строкам L
+void S21ConjugateGradient::SetMatrixPreconditioner(
+    const S21SparseMatrix& a, Preconditioner preconditioner) {
+  const int n = size_;
+
+  if (preconditioner == Preconditioner::kNone) {
+    preconditioner_ = nullptr;
+  } else if (preconditioner == Preconditioner::kJacobi) {
+    vector<double> inverse(n);
+    for (int i = 0; i < n; i++) {
+      const double diagonal = a(i, i);
+      if (!(diagonal > 0.0)) {
+        throw logic_error("Матрица не положительно определённая");
+      }
+      inverse[i] = 1.0 / diagonal;
+    }
+    preconditioner_ = [inverse](span<const double> r, span<double> z) {
+      for (size_t i = 0; i < inverse.size(); i++) z[i] = inverse[i] * r[i];
+    };
+  } else {
+    auto l = make_shared<S21SparseMatrix>(n, n);
+    for (int i = 0; i < n; i++) {
+      for (int k = a.offsets_[i]; k < a.offsets_[i + 1]; k++) {
+        if (a.columns_[k] > i) break;
+        l->columns_.push_back(a.columns_[k]);
+        l->values_.push_back(a.values_[k]);
+      }
+      l->offsets_[i + 1] = static_cast<int>(l->values_.size());
+      if (l->values_.empty() || l->columns_.back() != i) {
+        throw logic_error("Матрица не положительно определённая");
+      }
+    }
+
+    for (int i = 0; i < n; i++) {
+      const int row_begin = l->offsets_[i], row_end = l->offsets_[i + 1];
+      for (int p = row_begin; p < row_end; p++) {
+        const int k = l->columns_[p];
+        double sum = l->values_[p];
+        for (int x = row_begin, y = l->offsets_[k];
+             x < p && y < l->offsets_[k + 1] - 1;) {
+          if (l->columns_[x] < l->columns_[y]) {
+            x++;
+          } else if (l->columns_[x] > l->columns_[y]) {
+            y++;
+          } else {
+            sum -= l->values_[x++] * l->values_[y++];
+          }
+        }
+
+        if (k < i) {
+          l->values_[p] = sum / l->values_[l->offsets_[k + 1] - 1];
+        } else if (sum > 0.0) {
+          l->values_[p] = sqrt(sum);
+        } else {
+          throw logic_error("Неполное разложение Холецкого не существует");
+        }
+      }
+    }
+
+    preconditioner_ = [l](span<const double> r, span<double> z) {
+      const int n = l->rows_;
+      for (int i = 0; i < n; i++) {
+        double sum = r[i];
+        const int diagonal = l->offsets_[i + 1] - 1;
+        for (int k = l->offsets_[i]; k < diagonal; k++) {
+          sum -= l->values_[k] * z[l->columns_[k]];
+        }
+        z[i] = sum / l->values_[diagonal];
+      }
+      for (int i = n - 1; i >= 0; i--) {
+        const int diagonal = l->offsets_[i + 1] - 1;
+        z[i] /= l->values_[diagonal];
+        for (int k = l->offsets_[i]; k < diagonal; k++) {
+          z[l->columns_[k]] -= l->values_[k] * z[i];
+        }
+      }
+    };
+  }
+}
+
+S21Matrix S21ConjugateGradient::Solve(const S21Matrix& b) {
+  return Solve(b, S21Matrix(size_, b.GetCols() > 0 ? b.GetCols() : 1));
+}
+
+S21Matrix S21ConjugateGradient::Solve(const S21Matrix& b,
+                                      const S21Matrix& initial) {
+  if (b.GetRows() != size_ || b.GetCols() <= 0 ||
+      initial.GetRows() != size_ || initial.GetCols() != b.GetCols()) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+
+  Stats total;
+  total.converged = true;
+  S21Matrix x(size_, b.GetCols());
+  for (int c = 0; c < b.GetCols(); c++) {
+    for (int i = 0; i < size_; i++) {
+      r_[i] = b.Row(i)[c];
+      x_[i] = initial.Row(i)[c];
+    }
+
+    Stats stats;
+    SolveColumn(stats);
+    total.iterations = max(total.iterations, stats.iterations);
+    total.residual = max(total.residual, stats.residual);
+    total.converged = total.converged && stats.converged;
+    for (int i = 0; i < size_; i++) x.Row(i)[c] = x_[i];
+  }
+
+  stats_ = total;
+  return x;
+}
+
+// На входе r_ = b, x_ — начальное приближение; на выходе x_ — решение
+void S21ConjugateGradient::SolveColumn(Stats& stats) {
+  const double b_norm = sqrt(Dot(r_, r_));
+  if (b_norm == 0.0) {
+    fill(x_.begin(), x_.end(), 0.0);
+    stats.converged = true;
+    return;
+  }
+
+  apply_(x_, q_);
+  for (int i = 0; i < size_; i++) r_[i] -= q_[i];
+  double r_norm = sqrt(Dot(r_, r_));
+
+  auto precondition = [this]() {
+    if (preconditioner_) {
+      preconditioner_(r_, z_);
+    } else {
+      copy(r_.begin(), r_.end(), z_.begin());
+    }
+  };
+  precondition();
+  p_ = z_;
+  double rz = Dot(r_, z_);
+
+  while (r_norm > tolerance_ * b_norm && stats.iterations < max_iterations_) {
+    apply_(p_, q_);
+    const double pq = Dot(p_, q_);
+    // Оператор не положительно определён на p
+    if (!(pq > 0.0)) break;
+
+    const double alpha = rz / pq;
+    for (int i = 0; i < size_; i++) {
+      x_[i] += alpha * p_[i];
+      r_[i] -= alpha * q_[i];
+    }
+    r_norm = sqrt(Dot(r_, r_));
+    stats.iterations++;
+    if (r_norm <= tolerance_ * b_norm) break;
+
+    precondition();
+    const double rz_next = Dot(r_, z_);
+    const double beta = rz_next / rz;
+    rz = rz_next;
+    for (int i = 0; i < size_; i++) p_[i] = z_[i] + beta * p_[i];
+  }
+
+  stats.residual = r_norm / b_norm;
+  stats.converged = r_norm <= tolerance_ * b_norm;
+}
@@ -0,0 +1,71 @@
+#ifndef S21_CONJUGATE_GRADIENT_H
+#define S21_CONJUGATE_GRADIENT_H
+
+#include "s21_matrix_oop.h"
+#include "s21_sparse_matrix.h"
+
+// Метод сопряжённых градиентов для систем A X = B с симметричной
+// положительно определённой A. Оператор задаётся плотной или разреженной
+// матрицей (она должна жить дольше решателя) либо функцией y = A x, так
+// что сама матрица может вообще не храниться. Рабочие векторы выделяются
+// один раз и переиспользуются между итерациями и вызовами Solve
+class S21ConjugateGradient {
+ public:
+  // y = A x или z = M^-1 r; оба вектора длины GetSize()
+  using Operator = function<void(span<const double>, span<double>)>;
+
+  // Встроенные предобусловливатели для матричных операторов: диагональ
+  // A и неполное разложение Холецкого IC(0) по ненулевым элементам A
+  enum class Preconditioner { kNone, kJacobi, kIncompleteCholesky };
+
+  // Сходимость последнего вызова Solve; для нескольких правых частей —
+  // худший столбец
+  struct Stats {
+    int iterations = 0;
+    // |b - A x| / |b|
+    double residual = 0.0;
+    bool converged = false;
+  };
+
+ private:
+  int size_;
+  Operator apply_;
+  Operator preconditioner_;
+  double tolerance_;
+  int max_iterations_;
+  Stats stats_;
+  vector<double> x_, r_, z_, p_, q_;
+
+  void SetMatrixPreconditioner(const S21SparseMatrix& a,
+                               Preconditioner preconditioner);
+  void SolveColumn(Stats& stats);
+
+ public:
+  explicit S21ConjugateGradient(
+      const S21Matrix& a,
+      Preconditioner preconditioner = Preconditioner::kNone);
+  explicit S21ConjugateGradient(
+      const S21SparseMatrix& a,
+      Preconditioner preconditioner = Preconditioner::kNone);
+  S21ConjugateGradient(int size, Operator apply);
+
+  int GetSize() const { return size_; }
+  double GetTolerance() const { return tolerance_; }
+  int GetMaxIterations() const { return max_iterations_; }
+  const Stats& GetStats() const { return stats_; }
+
+  // Собственный предобусловливатель; пустая функция отключает его
+  void SetPreconditioner(Operator preconditioner);
+  // Остановка при |b - A x| <= tolerance * |b|; по умолчанию 1e-10 и
+  // 2 * size итераций
+  void SetTolerance(double tolerance);
+  void SetMaxIterations(int iterations);
+
+  // Начальное приближение — ноль или initial. Если метод не сошёлся за
+  // GetMaxIterations() итераций, возвращается последнее приближение, а
+  // GetStats().converged равно false
+  S21Matrix Solve(const S21Matrix& b);
+  S21Matrix Solve(const S21Matrix& b, const S21Matrix& initial);
+};
+
+#endif
@@ -0,0 +1,207 @@
+#include "s21_half_matrix.h"
+
+#include <bit>
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#include <immintrin.h>
+#define S21_HALF_MATRIX_F16C 1
+#endif
+
+namespace {
+
+// Округление double к ближайшему чётному в формат с kExponentBits битами
+// порядка и kMantissaBits битами мантиссы сразу, без промежуточного float:
+// округление через float было бы двойным. Пороги сравниваются по битам
+// модуля, которые для неотрицательных double упорядочены как числа
+template <int kExponentBits, int kMantissaBits>
+uint16_t RoundDouble(double value) {
+  constexpr int kBias = (1 << (kExponentBits - 1)) - 1;
+  constexpr int kShift = 52 - kMantissaBits;
+  constexpr uint16_t kInfinity = ((1 << kExponentBits) - 1) << kMantissaBits;
+  // Наименьшее нормальное число формата и граница переполнения
+  // (2 - 2^-(kMantissaBits + 1)) * 2^kBias
+  constexpr uint64_t kMinNormal = uint64_t(1023 + 1 - kBias) << 52;
+  constexpr uint64_t kOverflow =
+      (uint64_t(1023 + kBias) << 52) |
+      (((uint64_t(1) << (kMantissaBits + 1)) - 1) << (kShift - 1));
+  // Шаг субнормальных чисел формата: 2^(1 - kBias - kMantissaBits)
+  constexpr double kSubnormalScale =
+      bit_cast<double>(uint64_t(1023 + kBias - 1 + kMantissaBits) << 52);
+
+  const uint64_t bits = bit_cast<uint64_t>(value);
+  const uint16_t sign = static_cast<uint16_t>((bits >> 48) & 0x8000);
+  const uint64_t magnitude = bits & 0x7FFFFFFFFFFFFFFF;
+
+  if (magnitude > 0x7FF0000000000000) {
+    return sign | kInfinity | (1 << (kMantissaBits - 1));
+  }
+  if (magnitude >= kOverflow) return sign | kInfinity;
+  if (magnitude < kMinNormal) {
+    // Умножение на степень двойки точное, nearbyint округляет к чётному;
+    // перенос в порядок даёт наименьшее нормальное число
+    const double steps = bit_cast<double>(magnitude) * kSubnormalScale;
+    return sign | static_cast<uint16_t>(nearbyint(steps));
+  }
+
+  const uint64_t mantissa = magnitude & ((uint64_t(1) << 52) - 1);
+  const uint64_t exponent = (magnitude >> 52) - 1023 + kBias;
+  uint64_t result = (exponent << kMantissaBits) | (mantissa >> kShift);
+  const uint64_t rest = mantissa & ((uint64_t(1) << kShift) - 1);
+  const uint64_t half = uint64_t(1) << (kShift - 1);
+  if (rest > half || (rest == half && (result & 1))) result++;
+  return sign | static_cast<uint16_t>(result);
+}
+
+float HalfToFloat(uint16_t half) {
+  const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+  const uint32_t exponent = (half >> 10) & 0x1F, mantissa = half & 0x3FF;
+
+  if (exponent == 0x1F) {
+    return bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+  }
+  if (exponent == 0) {
+    const float subnormal = static_cast<float>(mantissa) * 0x1p-24f;
+    return sign ? -subnormal : subnormal;
+  }
+  return bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+float BFloatToFloat(uint16_t value) {
+  return bit_cast<float>(static_cast<uint32_t>(value) << 16);
+}
+
+#ifdef S21_HALF_MATRIX_F16C
+// Распаковка по восемь элементов; собирается с F16C и AVX2 независимо
+// от флагов сборки и вызывается, только если их поддерживает процессор.
+// Возвращает число обработанных элементов
+__attribute__((target("avx2,f16c"))) int DecodePacks(const uint16_t* source,
+                                                     int count, float* target,
+                                                     bool bfloat) {
+  int k = 0;
+  for (; k + 8 <= count; k += 8) {
+    const __m128i packed =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + k));
+    const __m256 values =
+        bfloat ? _mm256_castsi256_ps(
+                     _mm256_slli_epi32(_mm256_cvtepu16_epi32(packed), 16))
+               : _mm256_cvtph_ps(packed);
+    _mm256_storeu_ps(target + k, values);
+  }
+  return k;
+}
+
+bool HasF16c() {
+  static const bool supported =
+      __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+  return supported;
+}
+#endif
+
+}  // namespace
+
+S21HalfMatrix::S21HalfMatrix(int rows, int cols, Format format)
+    : rows_(rows), cols_(cols), format_(format) {
+  if (rows <= 0 || cols <= 0) {
+    throw invalid_argument("Строки и столбцы не могут быть меньше 0");
+  }
+  data_.assign(static_cast<size_t>(rows) * cols, 0);
+}
+
+void S21HalfMatrix::Encode(const double* source, int count,
+                           uint16_t* target) const {
+  for (int k = 0; k < count; k++) {
+    target[k] = format_ == Format::kBFloat16 ? RoundDouble<8, 7>(source[k])
+                                             : RoundDouble<5, 10>(source[k]);
+  }
+}
+
+void S21HalfMatrix::Decode(const uint16_t* source, int count,
+                           float* target) const {
+  int k = 0;
+  const bool bfloat = format_ == Format::kBFloat16;
+
+#ifdef S21_HALF_MATRIX_F16C
+  if (HasF16c()) k = DecodePacks(source, count, target, bfloat);
+#endif
+  for (; k < count; k++) {
+    target[k] = bfloat ? BFloatToFloat(source[k]) : HalfToFloat(source[k]);
+  }
+}
+
+double S21HalfMatrix::GetElement(int i, int j) const {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+
+  float value;
+  Decode(Row(i) + j, 1, &value);
+  return value;
+}
+
+void S21HalfMatrix::SetElement(int i, int j, double value) {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+
+  Encode(&value, 1, Row(i) + j);
+}
+
+S21HalfMatrix S21HalfMatrix::FromMatrix(const S21Matrix& matrix,
+                                        Format format) {
+  S21HalfMatrix result(matrix.rows_, matrix.cols_, format);
+  for (int i = 0; i < result.rows_; i++) {
+    result.Encode(matrix.Row(i), result.cols_, result.Row(i));
+  }
+  return result;
+}
+
+S21Matrix S21HalfMatrix::ToMatrix() const {
+  S21Matrix result(rows_, cols_);
+  vector<float> row(cols_);
+  for (int i = 0; i < rows_; i++) {
+    Decode(Row(i), cols_, row.data());
+    copy(row.begin(), row.end(), result.Row(i));
+  }
+  return result;
+}
+
+// Строки this распаковываются в буфер потока; строка результата
+// накапливается во float по строкам b (порядок i-k-j)
+S21Matrix S21HalfMatrix::Multiply(const S21Matrix& b) const {
+  if (b.rows_ != cols_) {
+    throw invalid_argument(
+        "Столбцы в первой матрице не должны быть равными строкам во второй");
+  }
+
+  const int width = b.cols_;
+  vector<float> b_float(static_cast<size_t>(cols_) * width);
+  for (int k = 0; k < cols_; k++) {
+    copy(b.Row(k), b.Row(k) + width,
+         b_float.begin() + static_cast<size_t>(k) * width);
+  }
+
+  S21Matrix result(rows_, width);
+  const size_t work = data_.size() * width;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    vector<float> a_row(cols_), sum(width);
+    for (int i = begin; i < end; i++) {
+      Decode(Row(i), cols_, a_row.data());
+
+      if (width == 1) {
+        float dot = 0.0f;
+        for (int k = 0; k < cols_; k++) dot += a_row[k] * b_float[k];
+        result.Row(i)[0] = dot;
+        continue;
+      }
+
+      fill(sum.begin(), sum.end(), 0.0f);
+      for (int k = 0; k < cols_; k++) {
+        const float aik = a_row[k];
+        const float* b_row = b_float.data() + static_cast<size_t>(k) * width;
+        for (int c = 0; c < width; c++) sum[c] += aik * b_row[c];
+      }
+      copy(sum.begin(), sum.end(), result.Row(i));
+    }
+  });
+  return result;
+}
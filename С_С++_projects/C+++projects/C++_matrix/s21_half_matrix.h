@@ -0,0 +1,53 @@
+#ifndef S21_HALF_MATRIX_H
+#define S21_HALF_MATRIX_H
+
+#include <cstdint>
+
+#include "s21_matrix_oop.h"
+
+// Матрица с 16-битными элементами: вчетверо меньше памяти, чем у
+// S21Matrix, ценой точности. kFloat16 — IEEE binary16 (11 бит мантиссы,
+// до 65504), kBFloat16 — старшие 16 бит float (8 бит мантиссы, диапазон
+// float). Элементы округляются из double к ближайшему чётному. Умножение
+// распаковывает строки во float на лету (F16C, если его поддерживает
+// процессор) и накапливает суммы во float
+class S21HalfMatrix {
+ public:
+  enum class Format { kFloat16, kBFloat16 };
+
+ private:
+  int rows_, cols_;
+  Format format_;
+  vector<uint16_t> data_;
+
+  const uint16_t* Row(int i) const {
+    return data_.data() + static_cast<size_t>(i) * cols_;
+  }
+  uint16_t* Row(int i) {
+    return data_.data() + static_cast<size_t>(i) * cols_;
+  }
+  void Encode(const double* source, int count, uint16_t* target) const;
+  void Decode(const uint16_t* source, int count, float* target) const;
+
+ public:
+  S21HalfMatrix(int rows, int cols, Format format);
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  Format GetFormat() const { return format_; }
+  // Объём хранимых элементов в байтах
+  size_t GetStorageBytes() const { return data_.size() * sizeof(uint16_t); }
+
+  double GetElement(int i, int j) const;
+  void SetElement(int i, int j, double value);
+
+  // Преобразования
+  static S21HalfMatrix FromMatrix(const S21Matrix& matrix, Format format);
+  S21Matrix ToMatrix() const;
+
+  // this * b с накоплением во float; b переводится во float один раз.
+  // Для b из одного столбца используется скалярное произведение строк
+  S21Matrix Multiply(const S21Matrix& b) const;
+};
+
+#endif
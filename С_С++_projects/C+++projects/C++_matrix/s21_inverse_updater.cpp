@@ -0,0 +1,90 @@
+#include "s21_inverse_updater.h"
+
+namespace {
+
+// Порог обусловленности поправки: при |det(I + V^T A^-1 U)| ниже него
+// формула теряет точность и обратная пересчитывается заново
+constexpr double kUpdateEps = 1e-8;
+
+S21Matrix Identity(int n) {
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1.0;
+  return identity;
+}
+
+}  // namespace
+
+S21InverseUpdater::S21InverseUpdater(const S21Matrix& matrix,
+                                     int refactor_interval)
+    : matrix_(matrix),
+      determinant_(0.0),
+      refactor_interval_(refactor_interval),
+      updates_since_refactor_(0) {
+  if (matrix.GetRows() != matrix.GetCols()) {
+    throw logic_error("Матрица не квадратная");
+  }
+  if (refactor_interval <= 0) {
+    throw invalid_argument("Интервал пересчёта должен быть больше 0");
+  }
+  Refactor();
+}
+
+void S21InverseUpdater::SetRefactorInterval(int interval) {
+  if (interval <= 0) {
+    throw invalid_argument("Интервал пересчёта должен быть больше 0");
+  }
+  refactor_interval_ = interval;
+}
+
+void S21InverseUpdater::Refactor() {
+  inverse_ = matrix_.Solve(Identity(matrix_.GetRows()));
+  determinant_ = matrix_.Determinant();
+  updates_since_refactor_ = 0;
+}
+
+// A += U V^T. Если матрица стала вырожденной, бросает logic_error и
+// оставляет состояние прежним
+void S21InverseUpdater::Update(const S21Matrix& u, const S21Matrix& v) {
+  const int n = matrix_.GetRows();
+  if (u.GetRows() != n || v.GetRows() != n || u.GetCols() != v.GetCols()) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+
+  const bool scheduled = updates_since_refactor_ + 1 >= refactor_interval_;
+  if (!scheduled && ApplyWoodbury(u, v)) {
+    matrix_.Gemm(1.0, u, v.Transposed(), 1.0);
+    updates_since_refactor_++;
+    return;
+  }
+
+  S21Matrix updated(matrix_);
+  updated.Gemm(1.0, u, v.Transposed(), 1.0);
+  S21Matrix inverse = updated.Solve(Identity(n));
+  matrix_ = std::move(updated);
+  inverse_ = std::move(inverse);
+  determinant_ = matrix_.Determinant();
+  updates_since_refactor_ = 0;
+}
+
+// (A + U V^T)^-1 = A^-1 - Z (I + V^T Z)^-1 V^T A^-1, Z = A^-1 U,
+// det(A + U V^T) = det A * det(I + V^T Z). Возвращает false, не меняя
+// обратную, если поправка I + V^T Z плохо обусловлена
+bool S21InverseUpdater::ApplyWoodbury(const S21Matrix& u, const S21Matrix& v) {
+  const int n = matrix_.GetRows(), k = u.GetCols();
+
+  S21Matrix z(n, k);
+  z.Gemm(1.0, inverse_, u, 0.0);
+  S21Matrix capacitance = Identity(k);
+  capacitance.Gemm(1.0, v.Transposed(), z, 1.0);
+
+  const double factor = capacitance.Determinant();
+  if (!(fabs(factor) >= kUpdateEps)) return false;
+
+  S21Matrix w(k, n);
+  w.Gemm(1.0, v.Transposed(), inverse_, 0.0);
+  S21Matrix y = capacitance.Solve(w);
+
+  inverse_.Gemm(-1.0, z, y, 1.0);
+  determinant_ *= factor;
+  return true;
+}
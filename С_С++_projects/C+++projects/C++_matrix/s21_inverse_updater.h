@@ -0,0 +1,40 @@
+#ifndef S21_INVERSE_UPDATER_H
+#define S21_INVERSE_UPDATER_H
+
+#include "s21_matrix_oop.h"
+
+// Обратная матрица и определитель для матрицы, которая меняется
+// обновлениями малого ранга A += U V^T (U и V размера n x k). Обновление
+// стоит O(n^2 k) по формуле Шермана — Моррисона — Вудбери и лемме об
+// определителе. Раз в refactor_interval обновлений, а также при плохо
+// обусловленной поправке обратная пересчитывается заново за O(n^3), чтобы
+// ошибки округления не накапливались
+class S21InverseUpdater {
+ private:
+  S21Matrix matrix_;
+  S21Matrix inverse_;
+  double determinant_;
+  int refactor_interval_;
+  int updates_since_refactor_;
+
+  bool ApplyWoodbury(const S21Matrix& u, const S21Matrix& v);
+
+ public:
+  explicit S21InverseUpdater(const S21Matrix& matrix,
+                             int refactor_interval = 64);
+
+  const S21Matrix& GetMatrix() const { return matrix_; }
+  const S21Matrix& GetInverse() const { return inverse_; }
+  double GetDeterminant() const { return determinant_; }
+  int GetRefactorInterval() const { return refactor_interval_; }
+  int GetUpdatesSinceRefactor() const { return updates_since_refactor_; }
+  void SetRefactorInterval(int interval);
+
+  // A += U V^T; бросает logic_error и не меняет состояние, если матрица
+  // стала вырожденной
+  void Update(const S21Matrix& u, const S21Matrix& v);
+  // Пересчёт обратной и определителя по текущей матрице
+  void Refactor();
+};
+
+#endif
@@ -1,159 +1,684 @@
 #include "s21_matrix_oop.h"
 
-// Параметризированный конструктор
-S21Matrix::S21Matrix(int rows, int cols) {
-  if (rows <= 0 || cols <= 0) {
-    throw invalid_argument("Строки и столбцы не могут быть меньше 0");
-  }
+#include <condition_variable>
+#include <deque>
+#include <numeric>
+#include <random>
 
-  double** new_matrix = nullptr;
+#include "s21_vector_math.h"
 
-  try {
-    new_matrix = new double*[rows];
-    for (int i = 0; i < rows; i++) {
-      new_matrix[i] = new double[cols]();
-    }
-  } catch (const bad_alloc&) {
-    if (new_matrix) {
-      for (int j = 0; j < rows; j++) {
-        delete[] new_matrix[j];
-      }
-      delete[] new_matrix;
-    }
-    throw;
+namespace {
+
+// Сумма op(x[j]) по строке. Восемь независимых аккумуляторов убирают
+// зависимость по сложению, и компилятор собирает цикл в векторные инструкции
+template <typename Op>
+double RowReduce(const double* x, int n, Op op) {
+  double acc[8] = {};
+  int j = 0;
+
+  for (; j + 8 <= n; j += 8) {
+    for (int k = 0; k < 8; k++) acc[k] += op(x[j + k]);
   }
+  for (; j < n; j++) acc[0] += op(x[j]);
 
-  rows_ = rows;
-  cols_ = cols;
-  matrix_ = new_matrix;
+  return ((acc[0] + acc[1]) + (acc[2] + acc[3])) +
+         ((acc[4] + acc[5]) + (acc[6] + acc[7]));
 }
 
-// Конструктор копирования
-S21Matrix::S21Matrix(const S21Matrix& other)
-    : rows_(0), cols_(0), matrix_(nullptr) {
-  if (this == &other) return;
+// Скалярное произведение с восемью аккумуляторами, как в RowReduce
+double Dot(const double* x, const double* y, int n) {
+  double acc[8] = {};
+  int j = 0;
 
-  if (other.matrix_ == nullptr) return;
+  for (; j + 8 <= n; j += 8) {
+    for (int k = 0; k < 8; k++) acc[k] += x[j + k] * y[j + k];
+  }
+  for (; j < n; j++) acc[0] += x[j] * y[j];
 
-  try {
-    rows_ = other.rows_;
-    cols_ = other.cols_;
-    matrix_ = new double*[rows_];
+  return ((acc[0] + acc[1]) + (acc[2] + acc[3])) +
+         ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+}
 
-    for (int i = 0; i < rows_; i++) {
-      matrix_[i] = new double[cols_];
-      copy(other.matrix_[i], other.matrix_[i] + cols_, matrix_[i]);
+// Шаг суммирования Ноймайера: ошибка округления копится в compensation
+inline void NeumaierAdd(double& sum, double& compensation, double value) {
+  const double t = sum + value;
+  if (fabs(sum) >= fabs(value)) {
+    compensation += (sum - t) + value;
+  } else {
+    compensation += (value - t) + sum;
+  }
+  sum = t;
+}
+
+template <typename Op>
+double RowReduceCompensated(const double* x, int n, Op op) {
+  double sum = 0.0, compensation = 0.0;
+  for (int j = 0; j < n; j++) NeumaierAdd(sum, compensation, op(x[j]));
+  return sum + compensation;
+}
+
+// Ведущий элемент меньше этого порога означает вырожденную матрицу
+constexpr double kSingularPivot = 1e-10;
+
+// Шаг разложения без отчёта о прогрессе
+struct NoProgress {
+  void operator()(int) const {}
+};
+
+// LU-разложение на месте с частичным выбором ведущего элемента: в a
+// остаются L (без единичной диагонали) и U. Возвращает false, если
+// ведущий элемент по модулю меньше eps. step(k) вызывается после шага k
+template <typename T, typename Step = NoProgress>
+bool LuFactor(T* a, int n, int* pivots, T eps, Step step = {}) {
+  auto row = [a, n](int i) { return a + static_cast<size_t>(i) * n; };
+
+  for (int k = 0; k < n; k++) {
+    int p = k;
+    for (int i = k + 1; i < n; i++) {
+      if (fabs(row(i)[k]) > fabs(row(p)[k])) p = i;
     }
-  } catch (const bad_alloc&) {
-    if (matrix_) {
-      for (int j = 0; j < rows_; j++) {
-        delete[] matrix_[j];
-      }
-      delete[] matrix_;
+
+    pivots[k] = p;
+    if (fabs(row(p)[k]) < eps) return false;
+    if (p != k) swap_ranges(row(k), row(k) + n, row(p));
+
+    const T* pivot_row = row(k);
+    for (int i = k + 1; i < n; i++) {
+      T* current = row(i);
+      const T factor = current[k] /= pivot_row[k];
+      for (int j = k + 1; j < n; j++) current[j] -= factor * pivot_row[j];
     }
-    throw;
+    step(k);
   }
+  return true;
 }
 
-// Конструктор переноса
-S21Matrix::S21Matrix(S21Matrix&& other) {
-  if (other.matrix_ == nullptr) return;
+// Решает LU x = P b на месте для одного столбца правой части
+template <typename T>
+void LuSolve(const T* lu, int n, const int* pivots, T* x) {
+  for (int k = 0; k < n; k++) {
+    if (pivots[k] != k) swap(x[k], x[pivots[k]]);
+  }
 
-  if (this == &other) return;
+  for (int i = 1; i < n; i++) {
+    const T* row = lu + static_cast<size_t>(i) * n;
+    T sum = x[i];
+    for (int j = 0; j < i; j++) sum -= row[j] * x[j];
+    x[i] = sum;
+  }
 
-  rows_ = other.rows_;
-  cols_ = other.cols_;
-  matrix_ = other.matrix_;
+  for (int i = n - 1; i >= 0; i--) {
+    const T* row = lu + static_cast<size_t>(i) * n;
+    T sum = x[i];
+    for (int j = i + 1; j < n; j++) sum -= row[j] * x[j];
+    x[i] = sum / row[i];
+  }
+}
 
-  other.rows_ = 0;
-  other.cols_ = 0;
-  other.matrix_ = nullptr;
+// Определитель по LU-разложению: произведение диагонали U со знаком
+// перестановки
+double LuDeterminant(const double* lu, int n, const int* pivots) {
+  double determinant = 1.0;
+  for (int k = 0; k < n; k++) {
+    determinant *= lu[static_cast<size_t>(k) * n + k];
+    if (pivots[k] != k) determinant = -determinant;
+  }
+  return determinant;
 }
 
-// Сеттеры
-void S21Matrix::SetRows(int new_rows) {
-  if (new_rows < 0) {
-    throw invalid_argument("Строки не могут быть меньше 0");
+// Обратная по LU-разложению в плотный буфер n x n: столбец c — решение
+// LU x = P e_c. step(c) вызывается перед столбцом c
+template <typename Step = NoProgress>
+void LuInvert(const double* lu, int n, const int* pivots, double* inverse,
+              Step step = {}) {
+  vector<double> column(n);
+  for (int c = 0; c < n; c++) {
+    step(c);
+    fill(column.begin(), column.end(), 0.0);
+    column[c] = 1.0;
+    LuSolve(lu, n, pivots, column.data());
+    for (int i = 0; i < n; i++) {
+      inverse[static_cast<size_t>(i) * n + c] = column[i];
+    }
+  }
+}
+
+// Решает A^T x = b по тому же разложению PA = LU, как dgetrs с 'T':
+// U^T z = b, L^T y = z, x = P^T y. Строки lu обходятся подряд
+template <typename T>
+void LuSolveTransposed(const T* lu, int n, const int* pivots, T* x) {
+  for (int i = 0; i < n; i++) {
+    const T* row = lu + static_cast<size_t>(i) * n;
+    x[i] /= row[i];
+    for (int j = i + 1; j < n; j++) x[j] -= row[j] * x[i];
   }
 
-  if (new_rows == rows_) {
-    return;
+  for (int i = n - 1; i > 0; i--) {
+    const T* row = lu + static_cast<size_t>(i) * n;
+    for (int j = 0; j < i; j++) x[j] -= row[j] * x[i];
+  }
+
+  for (int k = n - 1; k >= 0; k--) {
+    if (pivots[k] != k) swap(x[k], x[pivots[k]]);
   }
+}
+
+// Явные формулы для матриц 2x2, 3x3 и 4x4 без ветвлений. Для 4x4
+// используются миноры 2x2 верхней (s) и нижней (q) пар строк
+double Det2(const double* a, const double* b) {
+  return a[0] * b[1] - a[1] * b[0];
+}
+
+double Det3(const double* a, const double* b, const double* c) {
+  return a[0] * (b[1] * c[2] - b[2] * c[1]) -
+         a[1] * (b[0] * c[2] - b[2] * c[0]) +
+         a[2] * (b[0] * c[1] - b[1] * c[0]);
+}
+
+struct Minors4 {
+  double s[6], q[6];
+};
+
+Minors4 PairMinors(const double* a, const double* b, const double* c,
+                   const double* d) {
+  Minors4 m;
+  m.s[0] = a[0] * b[1] - b[0] * a[1];
+  m.s[1] = a[0] * b[2] - b[0] * a[2];
+  m.s[2] = a[0] * b[3] - b[0] * a[3];
+  m.s[3] = a[1] * b[2] - b[1] * a[2];
+  m.s[4] = a[1] * b[3] - b[1] * a[3];
+  m.s[5] = a[2] * b[3] - b[2] * a[3];
+  m.q[0] = c[0] * d[1] - d[0] * c[1];
+  m.q[1] = c[0] * d[2] - d[0] * c[2];
+  m.q[2] = c[0] * d[3] - d[0] * c[3];
+  m.q[3] = c[1] * d[2] - d[1] * c[2];
+  m.q[4] = c[1] * d[3] - d[1] * c[3];
+  m.q[5] = c[2] * d[3] - d[2] * c[3];
+  return m;
+}
+
+double Det4(const Minors4& m) {
+  return m.s[0] * m.q[5] - m.s[1] * m.q[4] + m.s[2] * m.q[3] +
+         m.s[3] * m.q[2] - m.s[4] * m.q[1] + m.s[5] * m.q[0];
+}
+
+// Присоединённая матрица: out[i] — строка результата
+void Adjugate2(const double* a, const double* b, double** out) {
+  out[0][0] = b[1];
+  out[0][1] = -a[1];
+  out[1][0] = -b[0];
+  out[1][1] = a[0];
+}
+
+void Adjugate3(const double* a, const double* b, const double* c,
+               double** out) {
+  out[0][0] = b[1] * c[2] - b[2] * c[1];
+  out[0][1] = a[2] * c[1] - a[1] * c[2];
+  out[0][2] = a[1] * b[2] - a[2] * b[1];
+  out[1][0] = b[2] * c[0] - b[0] * c[2];
+  out[1][1] = a[0] * c[2] - a[2] * c[0];
+  out[1][2] = a[2] * b[0] - a[0] * b[2];
+  out[2][0] = b[0] * c[1] - b[1] * c[0];
+  out[2][1] = a[1] * c[0] - a[0] * c[1];
+  out[2][2] = a[0] * b[1] - a[1] * b[0];
+}
+
+void Adjugate4(const double* a, const double* b, const double* c,
+               const double* d, const Minors4& m, double** out) {
+  const double* s = m.s;
+  const double* q = m.q;
+  out[0][0] = b[1] * q[5] - b[2] * q[4] + b[3] * q[3];
+  out[0][1] = -a[1] * q[5] + a[2] * q[4] - a[3] * q[3];
+  out[0][2] = d[1] * s[5] - d[2] * s[4] + d[3] * s[3];
+  out[0][3] = -c[1] * s[5] + c[2] * s[4] - c[3] * s[3];
+  out[1][0] = -b[0] * q[5] + b[2] * q[2] - b[3] * q[1];
+  out[1][1] = a[0] * q[5] - a[2] * q[2] + a[3] * q[1];
+  out[1][2] = -d[0] * s[5] + d[2] * s[2] - d[3] * s[1];
+  out[1][3] = c[0] * s[5] - c[2] * s[2] + c[3] * s[1];
+  out[2][0] = b[0] * q[4] - b[1] * q[2] + b[3] * q[0];
+  out[2][1] = -a[0] * q[4] + a[1] * q[2] - a[3] * q[0];
+  out[2][2] = d[0] * s[4] - d[1] * s[2] + d[3] * s[0];
+  out[2][3] = -c[0] * s[4] + c[1] * s[2] - c[3] * s[0];
+  out[3][0] = -b[0] * q[3] + b[1] * q[1] - b[2] * q[0];
+  out[3][1] = a[0] * q[3] - a[1] * q[1] + a[2] * q[0];
+  out[3][2] = -d[0] * s[3] + d[1] * s[1] - d[2] * s[0];
+  out[3][3] = c[0] * s[3] - c[1] * s[1] + c[2] * s[0];
+}
 
-  double** new_matrix = nullptr;
+const auto kIdentity = [](double v) { return v; };
+const auto kAbs = [](double v) { return fabs(v); };
+const auto kSquare = [](double v) { return v * v; };
+
+// Вычисление цепочки произведений по таблице разбиений split:
+// split[i * n + j] — последний множитель левой части для chain[i..j]
+class ChainEvaluator {
+ private:
+  const vector<const S21Matrix*>& chain_;
+  const vector<int>& split_;
+  vector<S21Matrix> pool_;
+
+  // Буфер rows x cols из освобождённых промежуточных результатов
+  S21Matrix Acquire(int rows, int cols) {
+    for (size_t k = 0; k < pool_.size(); k++) {
+      if (pool_[k].GetRowsCapacity() >= rows &&
+          pool_[k].GetColsCapacity() >= cols) {
+        S21Matrix buffer = std::move(pool_[k]);
+        pool_.erase(pool_.begin() + static_cast<ptrdiff_t>(k));
+        buffer.SetRows(0);
+        buffer.SetCols(cols);
+        buffer.SetRows(rows);
+        return buffer;
+      }
+    }
+    return S21Matrix(rows, cols);
+  }
 
-  try {
-    new_matrix = new double*[new_rows];
+ public:
+  ChainEvaluator(const vector<const S21Matrix*>& chain,
+                 const vector<int>& split)
+      : chain_(chain), split_(split) {}
 
-    int rows_to_copy = min(rows_, new_rows);
+  // target = chain[i] * ... * chain[j], i < j
+  void Multiply(int i, int j, S21Matrix& target) {
+    const int n = static_cast<int>(chain_.size());
+    const int s = split_[static_cast<size_t>(i) * n + j];
 
-    for (int i = 0; i < rows_to_copy; ++i) {
-      new_matrix[i] = new double[cols_];
-      copy(matrix_[i], matrix_[i] + cols_, new_matrix[i]);
+    S21Matrix left, right;
+    if (s > i) {
+      left = Acquire(chain_[i]->GetRows(), chain_[s]->GetCols());
+      Multiply(i, s, left);
+    }
+    if (j > s + 1) {
+      right = Acquire(chain_[s + 1]->GetRows(), chain_[j]->GetCols());
+      Multiply(s + 1, j, right);
     }
 
-    for (int i = rows_; i < new_rows; ++i) {
-      new_matrix[i] = new double[cols_]();
+    target.Gemm(1.0, s > i ? left : *chain_[i], j > s + 1 ? right : *chain_[j],
+                0.0);
+
+    if (s > i) pool_.push_back(std::move(left));
+    if (j > s + 1) pool_.push_back(std::move(right));
+  }
+};
+
+// Общий исполнитель асинхронных операций. Рабочие потоки создаются по мере
+// надобности, но не больше hardware_concurrency; задачи сверх этого ждут
+// в очереди. Простаивающие потоки живут до завершения программы
+class AsyncExecutor {
+ private:
+  mutex mutex_;
+  condition_variable_any ready_;
+  deque<function<void()>> tasks_;
+  size_t idle_ = 0;
+  // Объявлен последним: потоки останавливаются и присоединяются раньше,
+  // чем разрушается очередь
+  vector<jthread> workers_;
+
+  void Work(stop_token stop) {
+    unique_lock<mutex> lock(mutex_);
+    while (true) {
+      idle_++;
+      const bool ready =
+          ready_.wait(lock, stop, [&] { return !tasks_.empty(); });
+      idle_--;
+      if (!ready) return;
+
+      function<void()> task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
     }
+  }
+
+ public:
+  static AsyncExecutor& Instance() {
+    static AsyncExecutor executor;
+    return executor;
+  }
 
-    for (int i = 0; i < rows_; ++i) {
-      delete[] matrix_[i];
+  template <typename F>
+  auto Submit(F f) -> future<decltype(f())> {
+    auto task = make_shared<packaged_task<decltype(f())()>>(std::move(f));
+    auto result = task->get_future();
+
+    lock_guard<mutex> lock(mutex_);
+    tasks_.emplace_back([task] { (*task)(); });
+    const size_t limit = S21HardwareThreads();
+    if (idle_ < tasks_.size() && workers_.size() < limit) {
+      try {
+        workers_.emplace_back([this](stop_token stop) { Work(stop); });
+      } catch (const system_error&) {
+        // Без единого потока задача не выполнится никогда
+        if (workers_.empty()) {
+          tasks_.pop_back();
+          throw;
+        }
+      }
     }
+    ready_.notify_one();
+    return result;
+  }
+};
+
+}  // namespace
+
+// LU-разложение с выбором ведущего элемента и то, что из него следует.
+// После публикации в factorization_ не меняется, кроме ленивой обратной
+struct S21Matrix::Factorization {
+  vector<double> lu;
+  vector<int> pivots;
+  bool singular = false;
+  double determinant = 0.0;
+  mutable atomic<const S21Matrix*> inverse{nullptr};
+
+  ~Factorization() { delete inverse.load(); }
+};
+
+// Параметризированный конструктор
+S21Matrix::S21Matrix(int rows, int cols) : S21Matrix() {
+  if (rows <= 0 || cols <= 0) {
+    throw invalid_argument("Строки и столбцы не могут быть меньше 0");
+  }
+
+  const size_t size = static_cast<size_t>(rows) * cols;
+  if (size <= kSmallSize) {
+    fill(small_, small_ + size, 0.0);
+    matrix_ = small_;
+  } else {
+    matrix_ = new double[size]();
+  }
+
+  rows_ = rows;
+  cols_ = cols;
+  row_cap_ = rows;
+  stride_ = cols;
+}
+
+// Конструктор копирования
+S21Matrix::S21Matrix(const S21Matrix& other) : S21Matrix() { *this = other; }
+
+// Конструктор переноса
+S21Matrix::S21Matrix(S21Matrix&& other) noexcept : S21Matrix() {
+  *this = std::move(other);
+}
+
+// Работа с буфером
+
+// Копирует элементы в target с шагом строки stride
+void S21Matrix::CopyTo(double* target, int stride) const {
+  for (int i = 0; i < rows_; i++) {
+    copy(Row(i), Row(i) + cols_, target + static_cast<size_t>(i) * stride);
+  }
+}
+
+// Отпускает буфер; кучу освобождает последний владелец, внешний буфер
+// не освобождается
+void S21Matrix::Release() {
+  ClearCache();
+  if (!IsInline() && !external_ &&
+      (refs_ == nullptr || refs_->fetch_sub(1) == 1)) {
     delete[] matrix_;
+    delete refs_;
+  }
 
-    matrix_ = new_matrix;
-    rows_ = new_rows;
-  } catch (const bad_alloc&) {
-    if (new_matrix) {
-      for (int j = 0; j < rows_; j++) {
-        delete[] new_matrix[j];
-      }
-      delete[] new_matrix;
+  rows_ = 0;
+  cols_ = 0;
+  row_cap_ = 0;
+  stride_ = 0;
+  matrix_ = nullptr;
+  refs_ = nullptr;
+  external_ = false;
+  read_only_ = false;
+  exposed_ = false;
+}
+
+// Заменяет буфер на новый буфер в куче, сохраняя режим копирования при записи
+void S21Matrix::Adopt(double* matrix, int rows, int cols, int row_cap,
+                      int stride) {
+  atomic<int>* refs = nullptr;
+
+  if (cow_) {
+    try {
+      refs = new atomic<int>(1);
+    } catch (const bad_alloc&) {
+      delete[] matrix;
+      throw;
     }
-    throw;
   }
+
+  Release();
+  rows_ = rows;
+  cols_ = cols;
+  row_cap_ = row_cap;
+  stride_ = stride;
+  matrix_ = matrix;
+  refs_ = refs;
 }
 
-void S21Matrix::SetCols(int new_cols) {
-  if (new_cols < 0) {
-    throw invalid_argument("Столбцы не могут быть меньше 0");
+// Переносит элементы в собственный буфер заданной вместимости; небольшие
+// буферы размещаются внутри объекта
+void S21Matrix::Reallocate(int row_cap, int stride) {
+  const size_t size = static_cast<size_t>(row_cap) * stride;
+
+  if (size > kSmallSize) {
+    double* block = new double[size];
+    CopyTo(block, stride);
+    Adopt(block, rows_, cols_, row_cap, stride);
+    return;
   }
 
-  if (new_cols == cols_) {
+  double buffer[kSmallSize] = {};
+  CopyTo(buffer, stride);
+  const int rows = rows_, cols = cols_;
+
+  Release();
+  copy(buffer, buffer + size, small_);
+  rows_ = rows;
+  cols_ = cols;
+  row_cap_ = row_cap;
+  stride_ = stride;
+  matrix_ = small_;
+}
+
+// Вызывается перед любым изменением элементов: сбрасывает кэш и отделяет
+// общий или константный внешний буфер
+void S21Matrix::PrepareWrite() {
+  ClearCache();
+  if (read_only_) {
+    Reallocate(rows_, cols_);
     return;
   }
+  if (refs_ == nullptr || refs_->load() == 1) return;
+
+  Reallocate(row_cap_, stride_);
+}
 
-  double** new_matrix = nullptr;
+// Вызывается перед увеличением размеров: внешний буфер расти не может,
+// элементы переносятся в собственный с плотными строками
+void S21Matrix::OwnBuffer() {
+  if (external_) Reallocate(rows_, cols_);
+}
 
-  try {
-    new_matrix = new double*[rows_];
-    for (int i = 0; i < rows_; i++) {
-      new_matrix[i] = new double[new_cols]();
-    }
+// Изменения не выполняются одновременно с запросами, поэтому хватает
+// обычной проверки перед обменом
+void S21Matrix::ClearCache() {
+  if (factorization_.load(memory_order_relaxed) != nullptr) {
+    delete factorization_.exchange(nullptr);
+  }
+}
+
+// Раскладывает матрицу при первом запросе. Параллельные запросы к одной
+// матрице могут разложить её одновременно, в кэше останется первый
+// результат. Буфер, который может измениться в обход матрицы (внешний или
+// выданный через Data()), раскладывается заново при каждом запросе, и
+// разложение живёт в uncached
+const S21Matrix::Factorization& S21Matrix::Factorize(
+    unique_ptr<Factorization>& uncached) const {
+  const Factorization* cached = factorization_.load(memory_order_acquire);
+  if (cached != nullptr) return *cached;
+
+  const int n = rows_;
+  auto fresh = make_unique<Factorization>();
+  fresh->lu.resize(static_cast<size_t>(n) * n);
+  fresh->pivots.resize(n);
+  CopyTo(fresh->lu.data(), n);
+
+  fresh->singular =
+      !LuFactor(fresh->lu.data(), n, fresh->pivots.data(), kSingularPivot);
+  if (!fresh->singular) {
+    fresh->determinant =
+        LuDeterminant(fresh->lu.data(), n, fresh->pivots.data());
+  }
 
-    int cols_to_copy = min(cols_, new_cols);
+  if (external_ || exposed_) {
+    uncached = std::move(fresh);
+    return *uncached;
+  }
+
+  Factorization* expected = nullptr;
+  if (factorization_.compare_exchange_strong(expected, fresh.get(),
+                                             memory_order_acq_rel)) {
+    return *fresh.release();
+  }
+  return *expected;
+}
 
-    for (int i = 0; i < rows_; ++i) {
-      copy(matrix_[i], matrix_[i] + cols_to_copy, new_matrix[i]);
+void S21Matrix::SetCopyOnWrite(bool enabled) {
+  if (enabled && !cow_) {
+    if (matrix_ != nullptr && !IsInline() && !external_) {
+      refs_ = new atomic<int>(1);
     }
+    cow_ = true;
+  } else if (!enabled && cow_) {
+    if (refs_ != nullptr) PrepareWrite();
+    delete refs_;
+    refs_ = nullptr;
+    cow_ = false;
+  }
+}
+
+// Внешний буфер
+S21Matrix S21Matrix::View(double* data, int rows, int cols, int stride) {
+  if (data == nullptr) {
+    throw invalid_argument("Буфер не задан");
+  }
+  if (rows <= 0 || cols <= 0) {
+    throw invalid_argument("Строки и столбцы не могут быть меньше 0");
+  }
+  if (stride == 0) stride = cols;
+  if (stride < cols) {
+    throw invalid_argument("Шаг строки меньше числа столбцов");
+  }
 
-    for (int i = 0; i < rows_; ++i) {
-      delete[] matrix_[i];
+  S21Matrix result;
+  result.rows_ = rows;
+  result.cols_ = cols;
+  result.row_cap_ = rows;
+  result.stride_ = stride;
+  result.matrix_ = data;
+  result.external_ = true;
+  return result;
+}
+
+// Буфер не изменяется: PrepareWrite копирует элементы до первой записи
+S21Matrix S21Matrix::View(const double* data, int rows, int cols,
+                          int stride) {
+  S21Matrix result = View(const_cast<double*>(data), rows, cols, stride);
+  result.read_only_ = true;
+  return result;
+}
+
+// Вместимость
+void S21Matrix::Reserve(int rows, int cols) {
+  if (rows < 0 || cols < 0) {
+    throw invalid_argument("Строки и столбцы не могут быть меньше 0");
+  }
+
+  if (rows <= row_cap_ && cols <= stride_) return;
+
+  OwnBuffer();
+  Reallocate(max(rows, row_cap_), max(cols, stride_));
+}
+
+void S21Matrix::AppendRow(span<const double> values) {
+  if (rows_ == 0 && cols_ == 0) {
+    SetCols(static_cast<int>(values.size()));
+  }
+
+  if (values.size() != static_cast<size_t>(cols_)) {
+    throw invalid_argument("Размер строки не совпадает с числом столбцов");
+  }
+
+  const int row = rows_;
+  ClearCache();
+  OwnBuffer();
+
+  if (row == row_cap_ || IsShared()) {
+    // values может указывать в текущий буфер, который освободится
+    const less<const double*> before;
+    const double* end = matrix_ + static_cast<size_t>(row_cap_) * stride_;
+    if (!before(values.data(), matrix_) && before(values.data(), end)) {
+      vector<double> saved(values.begin(), values.end());
+      AppendRow(saved);
+      return;
     }
-    delete[] matrix_;
+    Reallocate(max(row + 1, 2 * row_cap_), stride_);
+  }
 
-    matrix_ = new_matrix;
+  copy(values.begin(), values.end(), Row(row));
+  rows_ = row + 1;
+}
+
+// Сеттеры
+void S21Matrix::SetRows(int new_rows) {
+  if (new_rows < 0) {
+    throw invalid_argument("Строки не могут быть меньше 0");
+  }
+
+  ClearCache();
+
+  if (new_rows <= rows_) {
+    rows_ = new_rows;
+    return;
+  }
+
+  OwnBuffer();
+  if (new_rows > row_cap_) {
+    Reallocate(max(new_rows, 2 * row_cap_), stride_);
+  } else {
+    PrepareWrite();
+  }
+
+  for (int i = rows_; i < new_rows; ++i) {
+    fill(Row(i), Row(i) + cols_, 0.0);
+  }
+  rows_ = new_rows;
+}
+
+void S21Matrix::SetCols(int new_cols) {
+  if (new_cols < 0) {
+    throw invalid_argument("Столбцы не могут быть меньше 0");
+  }
+
+  ClearCache();
+
+  if (new_cols <= cols_) {
     cols_ = new_cols;
+    return;
+  }
 
-  } catch (const bad_alloc&) {
-    if (new_matrix) {
-      for (int j = 0; j < rows_; j++) {
-        delete[] new_matrix[j];
-      }
-      delete[] new_matrix;
-    }
-    throw;
+  OwnBuffer();
+  if (new_cols > stride_) {
+    Reallocate(row_cap_, max(new_cols, 2 * stride_));
+  } else {
+    PrepareWrite();
   }
+
+  for (int i = 0; i < rows_; ++i) {
+    fill(Row(i) + cols_, Row(i) + new_cols, 0.0);
+  }
+  cols_ = new_cols;
 }
 
 void S21Matrix::SetElement(int i, int j, double value) {
@@ -167,12 +692,12 @@ bool S21Matrix::EqMatrix(const S21Matrix& other) const {
   const double eps = 1e-6;
 
   if (rows_ != other.rows_ || cols_ != other.cols_) {
-    flag = 0;
+    return false;
   }
 
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
-      if (fabs(matrix_[i][j] - other.matrix_[i][j]) >= eps) {
+      if (fabs(Row(i)[j] - other.Row(i)[j]) >= eps) {
         flag = 0;
         break;
       }
@@ -187,11 +712,7 @@ void S21Matrix::SumMatrix(const S21Matrix& other) {
     throw invalid_argument("Матрицы разного размера");
   }
 
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] += other.matrix_[i][j];
-    }
-  }
+  Zip(other, [](double x, double y) { return x + y; });
 }
 
 void S21Matrix::SubMatrix(const S21Matrix& other) {
@@ -199,19 +720,11 @@ void S21Matrix::SubMatrix(const S21Matrix& other) {
     throw invalid_argument("Матрицы разного размера");
   }
 
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] -= other.matrix_[i][j];
-    }
-  }
+  Zip(other, [](double x, double y) { return x - y; });
 }
 
 void S21Matrix::MulNumber(const double num) {
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] *= num;
-    }
-  }
+  Apply([num](double x) { return x * num; });
 }
 
 void S21Matrix::MulMatrix(const S21Matrix& other) {
@@ -221,29 +734,36 @@ void S21Matrix::MulMatrix(const S21Matrix& other) {
   }
 
   S21Matrix temp(rows_, other.cols_);
+  temp.Gemm(1.0, *this, other, 0.0);
 
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < other.cols_; j++) {
-      temp.matrix_[i][j] = 0;
-      for (int k = 0; k < cols_; k++)
-        temp.matrix_[i][j] += matrix_[i][k] * other.matrix_[k][j];
+  // Изменяемое представление остаётся над своим буфером, если размер
+  // не изменился; иначе результат переходит в собственный буфер
+  if (external_ && !read_only_ && other.cols_ == cols_) {
+    PrepareWrite();
+    for (int i = 0; i < rows_; i++) {
+      copy(temp.Row(i), temp.Row(i) + cols_, Row(i));
     }
+    return;
   }
 
-  *this = temp;
+  const bool cow = cow_;
+  *this = std::move(temp);
+  SetCopyOnWrite(cow);
 }
 
-S21Matrix S21Matrix::Transpose() {
+S21Matrix S21Matrix::Transpose() const {
   S21Matrix temp(cols_, rows_);
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
-      temp.matrix_[j][i] = matrix_[i][j];
+      temp.Row(j)[i] = Row(i)[j];
     }
   }
   return temp;
 }
 
-S21Matrix S21Matrix::CalcComplements() {
+// Для невырожденной матрицы n > 4 дополнения берутся из обратной:
+// C = det * (A^-1)^T. Для вырожденной и небольших считаются миноры
+S21Matrix S21Matrix::CalcComplements() const {
   if (rows_ != cols_) {
     throw logic_error("Матрица не квадратная");
   }
@@ -255,6 +775,20 @@ S21Matrix S21Matrix::CalcComplements() {
     return temp;
   }
 
+  unique_ptr<Factorization> uncached;
+  const Factorization* factorization =
+      rows_ > 4 ? &Factorize(uncached) : nullptr;
+  if (factorization != nullptr && !factorization->singular) {
+    const double det = factorization->determinant;
+    const S21Matrix inverse = InverseMatrix();
+    for (int i = 0; i < rows_; i++) {
+      for (int j = 0; j < cols_; j++) {
+        temp.Row(i)[j] = det * inverse.Row(j)[i];
+      }
+    }
+    return temp;
+  }
+
   for (int i = 0; i < rows_ && rows_ > 1; i++) {
     for (int j = 0; j < rows_; j++) {
       S21Matrix minor(rows_ - 1, cols_ - 1);
@@ -263,7 +797,7 @@ S21Matrix S21Matrix::CalcComplements() {
         if (y == i) continue;
         for (int x = 0, mj = 0; x < rows_; x++) {
           if (x == j) continue;
-          minor(mi, mj++) = (*this)(y, x);
+          minor(mi, mj++) = Row(y)[x];
           ;
         }
         mi++;
@@ -278,7 +812,7 @@ S21Matrix S21Matrix::CalcComplements() {
   return temp;
 }
 
-double S21Matrix::Determinant() {
+double S21Matrix::Determinant() const {
   if (rows_ != cols_) {
     throw logic_error("Матрица не квадратная");
   }
@@ -287,110 +821,1489 @@ double S21Matrix::Determinant() {
     return 0.0;
   }
 
-  const double eps = 1e-10;
-
-  if (rows_ == 1) {
-    return matrix_[0][0];
+  switch (rows_) {
+    case 1:
+      return Row(0)[0];
+    case 2:
+      return Det2(Row(0), Row(1));
+    case 3:
+      return Det3(Row(0), Row(1), Row(2));
+    case 4:
+      return Det4(PairMinors(Row(0), Row(1), Row(2), Row(3)));
   }
 
-  double determinant = 1.0;
-
-  S21Matrix temp(*this);
-
-  for (int i = 0; i < rows_ && determinant != 0.0; i++) {
-    int max_row = i;
-    for (int k = i + 1; k < rows_; k++) {
-      if (fabs(temp.matrix_[k][i]) > fabs(temp.matrix_[max_row][i])) {
-        max_row = k;
-      }
-    }
+  unique_ptr<Factorization> uncached;
+  const Factorization& factorization = Factorize(uncached);
+  return factorization.singular ? 0.0 : factorization.determinant;
+}
 
-    if (fabs(temp.matrix_[max_row][i]) < eps) {
-      determinant = 0.0;
-      break;
-    }
+S21Matrix S21Matrix::InverseMatrix() const {
+  if (rows_ != cols_) {
+    throw logic_error("Матрица не квадратная");
+  }
 
-    if (max_row != i) {
-      swap(temp.matrix_[i], temp.matrix_[max_row]);
-      determinant *= -1;
+  // Вырожденность для всех размеров определяется ведущими элементами
+  // LU-разложения, а не абсолютной величиной определителя: иначе 0.001 * I
+  // была бы вырожденной при n = 4 и обратимой при n = 5. Для n <= 4
+  // разложение делается на стеке и в кэш не попадает
+  if (rows_ <= 4) {
+    double lu[16];
+    int pivots[4];
+    CopyTo(lu, rows_);
+    if (!LuFactor(lu, rows_, pivots, kSingularPivot)) {
+      throw logic_error("Матрица вырожденная, обратной не сущестсвует");
     }
 
-    for (int k = i + 1; k < rows_; k++) {
-      double factor = temp.matrix_[k][i] / temp.matrix_[i][i];
-      for (int j = i; j < rows_; j++) {
-        temp.matrix_[k][j] -= factor * temp.matrix_[i][j];
-      }
+    S21Matrix result(rows_, rows_);
+    double* out[4] = {};
+    for (int i = 0; i < rows_; i++) out[i] = result.Row(i);
+    double det = 0.0;
+
+    if (rows_ == 1) {
+      det = Row(0)[0];
+      out[0][0] = 1.0;
+    } else if (rows_ == 2) {
+      det = Det2(Row(0), Row(1));
+      Adjugate2(Row(0), Row(1), out);
+    } else if (rows_ == 3) {
+      det = Det3(Row(0), Row(1), Row(2));
+      Adjugate3(Row(0), Row(1), Row(2), out);
+    } else {
+      const Minors4 minors = PairMinors(Row(0), Row(1), Row(2), Row(3));
+      det = Det4(minors);
+      Adjugate4(Row(0), Row(1), Row(2), Row(3), minors, out);
     }
 
-    determinant *= temp.matrix_[i][i];
-  }
-  return determinant;
-}
-
-S21Matrix S21Matrix::InverseMatrix() {
-  if (rows_ != cols_) {
-    throw logic_error("Матрица не квадратная");
+    result.MulNumber(1.0 / det);
+    return result;
   }
 
-  double det = Determinant();
-  const double eps = 1e-10;
-
-  if (fabs(det) < eps) {
+  unique_ptr<Factorization> uncached;
+  const Factorization& factorization = Factorize(uncached);
+  if (factorization.singular) {
     throw logic_error("Матрица вырожденная, обратной не сущестсвует");
   }
 
-  S21Matrix complements = this->CalcComplements();
-  S21Matrix adjoint = complements.Transpose();
+  // Столбцы обратной — решения LU x = P e_c; результат хранится в кэше
+  const S21Matrix* cached = factorization.inverse.load(memory_order_acquire);
+  if (cached != nullptr) return *cached;
 
-  double inv_det = 1.0 / det;
-  adjoint.MulNumber(inv_det);
+  const int n = rows_;
+  auto inverse = make_unique<S21Matrix>(n, n);
+  LuInvert(factorization.lu.data(), n, factorization.pivots.data(),
+           inverse->Row(0));
 
-  return adjoint;
+  const S21Matrix* expected = nullptr;
+  if (factorization.inverse.compare_exchange_strong(
+          expected, inverse.get(), memory_order_acq_rel)) {
+    return *inverse.release();
+  }
+  return *expected;
 }
 
-// Перегрузка операторов
-
-S21Matrix& S21Matrix::operator=(const S21Matrix& other) {
-  if (this != &other) {
-    for (int i = 0; i < rows_; i++) {
-      delete[] matrix_[i];
-    }
-    delete[] matrix_;
-
-    try {
-      rows_ = other.rows_;
-      cols_ = other.cols_;
-      matrix_ = new double*[rows_];
-      for (int i = 0; i < rows_; i++) {
-        matrix_[i] = new double[cols_];
-        copy(other.matrix_[i], other.matrix_[i] + cols_, matrix_[i]);
-      }
-    } catch (const bad_alloc&) {
-      if (matrix_) {
-        for (int j = 0; j < rows_; j++) {
-          delete[] matrix_[j];
-        }
-        delete[] matrix_;
-      }
-      throw;
-    }
-  }
+// this = beta * this
+S21Matrix& S21Matrix::Scale(double beta) {
+  MulNumber(beta);
   return *this;
 }
 
-S21Matrix S21Matrix::operator+(const S21Matrix& other) {
+// this += alpha * other за один проход
+S21Matrix& S21Matrix::AddScaled(double alpha, const S21Matrix& other) {
   if (rows_ != other.rows_ || cols_ != other.cols_) {
     throw invalid_argument("Матрицы разного размера");
   }
 
-  S21Matrix temp(*this);
-  temp.SumMatrix(other);
-  return temp;
-}
+  PrepareWrite();
 
-bool S21Matrix::operator==(const S21Matrix& other) const {
-  return EqMatrix(other);
-}
+  for (int i = 0; i < rows_; i++) {
+    double* row = Row(i);
+    const double* other_row = other.Row(i);
+    for (int j = 0; j < cols_; j++) {
+      row[j] += alpha * other_row[j];
+    }
+  }
+  return *this;
+}
+
+// this = alpha * a * b + beta * this
+S21Matrix& S21Matrix::Gemm(double alpha, const S21Matrix& a,
+                           const S21Matrix& b, double beta) {
+  return GemmImpl(alpha, a, false, b, false, beta);
+}
+
+S21Matrix& S21Matrix::Gemm(double alpha, TransposedView a, const S21Matrix& b,
+                           double beta) {
+  return GemmImpl(alpha, a.Base(), true, b, false, beta);
+}
+
+S21Matrix& S21Matrix::Gemm(double alpha, const S21Matrix& a, TransposedView b,
+                           double beta) {
+  return GemmImpl(alpha, a, false, b.Base(), true, beta);
+}
+
+S21Matrix& S21Matrix::Gemm(double alpha, TransposedView a, TransposedView b,
+                           double beta) {
+  return GemmImpl(alpha, a.Base(), true, b.Base(), true, beta);
+}
+
+// this = alpha * op(a) * op(b) + beta * this, где op транспонирует
+// операнд, если установлен флаг. Если this совпадает с a или b, результат
+// считается через копию
+S21Matrix& S21Matrix::GemmImpl(double alpha, const S21Matrix& a, bool trans_a,
+                               const S21Matrix& b, bool trans_b, double beta) {
+  const int a_rows = trans_a ? a.cols_ : a.rows_;
+  const int inner = trans_a ? a.rows_ : a.cols_;
+  const int b_rows = trans_b ? b.cols_ : b.rows_;
+  const int b_cols = trans_b ? b.rows_ : b.cols_;
+  if (inner != b_rows) {
+    throw invalid_argument(
+        "Столбцы в первой матрице не должны быть равными строкам во второй");
+  }
+  if (rows_ != a_rows || cols_ != b_cols) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+
+  if (this == &a || this == &b) {
+    S21Matrix copy(*this);
+    return GemmImpl(alpha, this == &a ? copy : a, trans_a,
+                    this == &b ? copy : b, trans_b, beta);
+  }
+
+  PrepareWrite();
+
+  const size_t work = static_cast<size_t>(rows_) * cols_ * inner;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    GemmRows(alpha, a, trans_a, b, trans_b, beta, begin, end);
+  });
+  return *this;
+}
+
+S21Matrix& S21Matrix::Gemv(double alpha, const S21Matrix& a,
+                           const S21Matrix& x, double beta) {
+  return GemvImpl(alpha, a, false, x, beta);
+}
+
+S21Matrix& S21Matrix::Gemv(double alpha, TransposedView a, const S21Matrix& x,
+                           double beta) {
+  return GemvImpl(alpha, a.Base(), true, x, beta);
+}
+
+// Столбцы x и this копируются в непрерывные массивы: шаг строки у
+// столбца может быть больше 1, а копия x снимает вопрос о совпадении
+// x и this
+S21Matrix& S21Matrix::GemvImpl(double alpha, const S21Matrix& a, bool trans_a,
+                               const S21Matrix& x, double beta) {
+  const int a_rows = trans_a ? a.cols_ : a.rows_;
+  const int a_cols = trans_a ? a.rows_ : a.cols_;
+  if (x.cols_ != 1 || x.rows_ != a_cols || cols_ != 1 || rows_ != a_rows) {
+    throw invalid_argument("Вектор не соответствует матрице");
+  }
+
+  vector<double> xs(a_cols), y(a_rows);
+  for (int k = 0; k < a_cols; k++) xs[k] = x.Row(k)[0];
+  for (int i = 0; i < a_rows; i++) {
+    y[i] = beta == 0.0 ? 0.0 : beta * Row(i)[0];
+  }
+
+  const size_t work = static_cast<size_t>(a_rows) * a_cols;
+  if (!trans_a) {
+    S21ParallelFor(a_rows, work, [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        y[i] += alpha * Dot(a.Row(i), xs.data(), a_cols);
+      }
+    });
+  } else {
+    // y += alpha * x[k] * a(k, :): потоки делят элементы y, а строки a
+    // читаются подряд
+    S21ParallelFor(a_rows, work, [&](int begin, int end) {
+      for (int k = 0; k < a_cols; k++) {
+        const double xk = alpha * xs[k];
+        const double* a_row = a.Row(k);
+        for (int i = begin; i < end; i++) y[i] += xk * a_row[i];
+      }
+    });
+  }
+
+  PrepareWrite();
+  for (int i = 0; i < a_rows; i++) Row(i)[0] = y[i];
+  return *this;
+}
+
+// Сторона блока для SymmetricRankKUpdate: блок результата 64 x 64
+// занимает 32 КБ и остаётся в кэше, пока по нему идёт накопление
+constexpr int kSyrkBlock = 64;
+
+S21Matrix& S21Matrix::SymmetricRankKUpdate(double alpha, const S21Matrix& a,
+                                           double beta) {
+  return SyrkImpl(alpha, a, false, beta);
+}
+
+S21Matrix& S21Matrix::SymmetricRankKUpdate(double alpha, TransposedView a,
+                                           double beta) {
+  return SyrkImpl(alpha, a.Base(), true, beta);
+}
+
+// Верхний треугольник делится на блоки, потоки получают блоки целиком.
+// trans: накопление строками a (C(i, j) += a(k, i) * a(k, j)), иначе
+// C(i, j) — скалярное произведение строк i и j
+S21Matrix& S21Matrix::SyrkImpl(double alpha, const S21Matrix& a, bool trans,
+                               double beta) {
+  const int n = trans ? a.cols_ : a.rows_;
+  const int inner = trans ? a.rows_ : a.cols_;
+  if (rows_ != n || cols_ != n) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+
+  if (this == &a) {
+    S21Matrix copy(a);
+    return SyrkImpl(alpha, copy, trans, beta);
+  }
+
+  PrepareWrite();
+
+  vector<pair<int, int>> blocks;
+  for (int bi = 0; bi < n; bi += kSyrkBlock) {
+    for (int bj = bi; bj < n; bj += kSyrkBlock) blocks.push_back({bi, bj});
+  }
+
+  const int count = static_cast<int>(blocks.size());
+  const size_t work = static_cast<size_t>(n) * (n + 1) / 2 * inner;
+  S21ParallelFor(count, work, [&](int begin, int end) {
+    for (int b = begin; b < end; b++) {
+      const int i_begin = blocks[b].first, j_begin = blocks[b].second;
+      const int i_end = min(n, i_begin + kSyrkBlock);
+      const int j_end = min(n, j_begin + kSyrkBlock);
+
+      for (int i = i_begin; i < i_end; i++) {
+        double* row = Row(i);
+        for (int j = max(j_begin, i); j < j_end; j++) {
+          row[j] = beta == 0.0 ? 0.0 : beta * row[j];
+        }
+      }
+
+      if (trans) {
+        for (int k = 0; k < inner; k++) {
+          const double* a_row = a.Row(k);
+          for (int i = i_begin; i < i_end; i++) {
+            const double aki = alpha * a_row[i];
+            double* row = Row(i);
+            for (int j = max(j_begin, i); j < j_end; j++) {
+              row[j] += aki * a_row[j];
+            }
+          }
+        }
+      } else {
+        for (int i = i_begin; i < i_end; i++) {
+          double* row = Row(i);
+          for (int j = max(j_begin, i); j < j_end; j++) {
+            row[j] += alpha * Dot(a.Row(i), a.Row(j), inner);
+          }
+        }
+      }
+    }
+  });
+
+  for (int i = 1; i < n; i++) {
+    double* row = Row(i);
+    for (int j = 0; j < i; j++) row[j] = Row(j)[i];
+  }
+  return *this;
+}
+
+// Редукции
+// Частичные суммы считаются по строкам, а не по блокам потоков, и
+// складываются в одном порядке, поэтому результат не зависит от числа
+// потоков
+template <typename Op>
+double S21Matrix::ReduceAll(Op op, bool compensated) const {
+  vector<double> partial(rows_);
+
+  const size_t work = static_cast<size_t>(rows_) * cols_;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      partial[i] = compensated ? RowReduceCompensated(Row(i), cols_, op)
+                               : RowReduce(Row(i), cols_, op);
+    }
+  });
+
+  return compensated ? RowReduceCompensated(partial.data(), rows_, kIdentity)
+                     : RowReduce(partial.data(), rows_, kIdentity);
+}
+
+// Суммы по столбцам: потоки делят столбцы, внутренний цикл идёт по строке
+template <typename Op>
+vector<double> S21Matrix::ReduceCols(Op op, bool compensated) const {
+  vector<double> sums(cols_, 0.0);
+  vector<double> compensation(compensated ? cols_ : 0, 0.0);
+
+  const size_t work = static_cast<size_t>(rows_) * cols_;
+  S21ParallelFor(cols_, work, [&](int begin, int end) {
+    for (int i = 0; i < rows_; i++) {
+      const double* row = Row(i);
+      if (compensated) {
+        for (int j = begin; j < end; j++) {
+          NeumaierAdd(sums[j], compensation[j], op(row[j]));
+        }
+      } else {
+        for (int j = begin; j < end; j++) sums[j] += op(row[j]);
+      }
+    }
+  });
+
+  for (size_t j = 0; j < compensation.size(); j++) {
+    sums[j] += compensation[j];
+  }
+  return sums;
+}
+
+double S21Matrix::Sum(bool compensated) const {
+  return ReduceAll(kIdentity, compensated);
+}
+
+double S21Matrix::FrobeniusNorm(bool compensated) const {
+  return sqrt(ReduceAll(kSquare, compensated));
+}
+
+// Максимальная сумма модулей по столбцам
+double S21Matrix::Norm1() const {
+  vector<double> sums = ReduceCols(kAbs, false);
+  return sums.empty() ? 0.0 : *max_element(sums.begin(), sums.end());
+}
+
+// Максимальная сумма модулей по строкам
+double S21Matrix::NormInf() const {
+  vector<double> partial(rows_);
+
+  const size_t work = static_cast<size_t>(rows_) * cols_;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      partial[i] = RowReduce(Row(i), cols_, kAbs);
+    }
+  });
+
+  double norm = 0.0;
+  for (double sum : partial) norm = max(norm, sum);
+  return norm;
+}
+
+double S21Matrix::Min() const {
+  pair<int, int> index = ArgMin();
+  return Row(index.first)[index.second];
+}
+
+double S21Matrix::Max() const {
+  pair<int, int> index = ArgMax();
+  return Row(index.first)[index.second];
+}
+
+pair<int, int> S21Matrix::ArgMin() const {
+  if (rows_ == 0 || cols_ == 0) {
+    throw logic_error("Матрица пустая");
+  }
+
+  pair<int, int> best(0, 0);
+  for (int i = 0; i < rows_; i++) {
+    const double* row = Row(i);
+    const int j = static_cast<int>(min_element(row, row + cols_) - row);
+    if (row[j] < Row(best.first)[best.second]) best = {i, j};
+  }
+  return best;
+}
+
+pair<int, int> S21Matrix::ArgMax() const {
+  if (rows_ == 0 || cols_ == 0) {
+    throw logic_error("Матрица пустая");
+  }
+
+  pair<int, int> best(0, 0);
+  for (int i = 0; i < rows_; i++) {
+    const double* row = Row(i);
+    const int j = static_cast<int>(max_element(row, row + cols_) - row);
+    if (row[j] > Row(best.first)[best.second]) best = {i, j};
+  }
+  return best;
+}
+
+S21Matrix S21Matrix::RowSums(bool compensated) const {
+  S21Matrix result(rows_, 1);
+
+  const size_t work = static_cast<size_t>(rows_) * cols_;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      const double* row = Row(i);
+      result.Row(i)[0] =
+          compensated ? RowReduceCompensated(row, cols_, kIdentity)
+                      : RowReduce(row, cols_, kIdentity);
+    }
+  });
+  return result;
+}
+
+S21Matrix S21Matrix::ColSums(bool compensated) const {
+  S21Matrix result(1, cols_);
+  vector<double> sums = ReduceCols(kIdentity, compensated);
+  copy(sums.begin(), sums.end(), result.Row(0));
+  return result;
+}
+
+S21Matrix S21Matrix::ColMeans(bool compensated) const {
+  S21Matrix result = ColSums(compensated);
+  result.MulNumber(1.0 / rows_);
+  return result;
+}
+
+// Векторизованные функции
+template <typename F>
+S21Matrix& S21Matrix::ApplyKernel(F f) {
+  PrepareWrite();
+
+  const size_t work = static_cast<size_t>(rows_) * cols_;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) f(Row(i), cols_);
+  });
+  return *this;
+}
+
+S21Matrix& S21Matrix::ApplyExp() {
+  return ApplyKernel(s21_vector_math::ExpArray);
+}
+
+S21Matrix& S21Matrix::ApplyLog() {
+  return ApplyKernel(s21_vector_math::LogArray);
+}
+
+S21Matrix& S21Matrix::ApplyTanh() {
+  return ApplyKernel(s21_vector_math::TanhArray);
+}
+
+S21Matrix& S21Matrix::ApplySigmoid() {
+  return ApplyKernel(s21_vector_math::SigmoidArray);
+}
+
+// Вычитание максимума строки исключает переполнение exp
+S21Matrix& S21Matrix::SoftmaxRows() {
+  PrepareWrite();
+
+  const size_t work = static_cast<size_t>(rows_) * cols_;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* row = Row(i);
+      const double row_max = *max_element(row, row + cols_);
+      for (int j = 0; j < cols_; j++) row[j] -= row_max;
+      s21_vector_math::ExpArray(row, cols_);
+      const double scale = 1.0 / RowReduce(row, cols_, kIdentity);
+      for (int j = 0; j < cols_; j++) row[j] *= scale;
+    }
+  });
+  return *this;
+}
+
+// Операции с векторами
+// this(i, j) = f(this(i, j), row(0, j))
+template <typename F>
+S21Matrix& S21Matrix::BroadcastRow(const S21Matrix& row, F f) {
+  if (row.rows_ != 1 || row.cols_ != cols_) {
+    throw invalid_argument("Вектор не соответствует матрице");
+  }
+
+  PrepareWrite();
+  const double* v = row.Row(0);
+
+  const size_t work = static_cast<size_t>(rows_) * cols_;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* target = Row(i);
+      for (int j = 0; j < cols_; j++) target[j] = f(target[j], v[j]);
+    }
+  });
+  return *this;
+}
+
+// this(i, j) = f(this(i, j), col(i, 0))
+template <typename F>
+S21Matrix& S21Matrix::BroadcastCol(const S21Matrix& col, F f) {
+  if (col.cols_ != 1 || col.rows_ != rows_) {
+    throw invalid_argument("Вектор не соответствует матрице");
+  }
+
+  PrepareWrite();
+
+  const size_t work = static_cast<size_t>(rows_) * cols_;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* target = Row(i);
+      const double c = col.Row(i)[0];
+      for (int j = 0; j < cols_; j++) target[j] = f(target[j], c);
+    }
+  });
+  return *this;
+}
+
+S21Matrix& S21Matrix::AddRowVector(const S21Matrix& row) {
+  return BroadcastRow(row, [](double x, double v) { return x + v; });
+}
+
+S21Matrix& S21Matrix::AddColVector(const S21Matrix& col) {
+  return BroadcastCol(col, [](double x, double c) { return x + c; });
+}
+
+S21Matrix& S21Matrix::ScaleRows(const S21Matrix& col) {
+  return BroadcastCol(col, [](double x, double c) { return x * c; });
+}
+
+S21Matrix& S21Matrix::ScaleCols(const S21Matrix& row) {
+  return BroadcastRow(row, [](double x, double v) { return x * v; });
+}
+
+// Центрирование столбцов: проход за средними и проход с вычитанием
+S21Matrix& S21Matrix::SubtractColMeans(bool compensated) {
+  if (rows_ == 0 || cols_ == 0) {
+    throw logic_error("Матрица пустая");
+  }
+
+  S21Matrix means = ColMeans(compensated);
+  return BroadcastRow(means, [](double x, double m) { return x - m; });
+}
+
+S21Matrix S21Matrix::Gram() const {
+  if (rows_ == 0 || cols_ == 0) {
+    throw logic_error("Матрица пустая");
+  }
+
+  S21Matrix result(cols_, cols_);
+  result.SymmetricRankKUpdate(1.0, Transposed(), 0.0);
+  return result;
+}
+
+// (X - среднее)^T (X - среднее) / (rows - 1)
+S21Matrix S21Matrix::Covariance() const {
+  if (rows_ < 2) {
+    throw logic_error("Для ковариации нужно хотя бы два наблюдения");
+  }
+
+  S21Matrix centered(*this);
+  centered.SubtractColMeans();
+  S21Matrix result(cols_, cols_);
+  result.SymmetricRankKUpdate(1.0 / (rows_ - 1), centered.Transposed(), 0.0);
+  return result;
+}
+
+S21Matrix S21Matrix::Pow(int k) const {
+  if (rows_ != cols_) {
+    throw logic_error("Матрица не квадратная");
+  }
+
+  const int n = rows_;
+  unsigned power = k >= 0 ? k : 0u - static_cast<unsigned>(k);
+  if (power == 0) {
+    S21Matrix identity(n, n);
+    for (int i = 0; i < n; i++) identity.Row(i)[i] = 1.0;
+    return identity;
+  }
+
+  // base пробегает A, A^2, A^4, ...; result накапливает степени для
+  // единичных битов k. Произведения пишутся в scratch и меняются местами
+  S21Matrix base = k >= 0 ? *this : InverseMatrix();
+  S21Matrix result, scratch(n, n);
+  for (;;) {
+    if (power & 1) {
+      if (result.rows_ == 0) {
+        result = base;
+      } else {
+        scratch.Gemm(1.0, result, base, 0.0);
+        swap(result, scratch);
+      }
+    }
+    power >>= 1;
+    if (power == 0) break;
+    scratch.Gemm(1.0, base, base, 0.0);
+    swap(base, scratch);
+  }
+  return result;
+}
+
+// Степени аппроксимаций Паде для exp, их коэффициенты b_0..b_m и
+// theta_m: при |A|_1 <= theta_m ошибка r_m(A) не превышает
+// единицы округления double (Higham, 2005, таблица 2.3)
+constexpr int kPadeDegrees[] = {3, 5, 7, 9, 13};
+constexpr double kPadeTheta[] = {1.495585217958292e-2, 2.539398330063230e-1,
+                                 9.504178996162932e-1, 2.097847961257068e0,
+                                 5.371920351148152e0};
+constexpr double kPade3[] = {120.0, 60.0, 12.0, 1.0};
+constexpr double kPade5[] = {30240.0, 15120.0, 3360.0, 420.0, 30.0, 1.0};
+constexpr double kPade7[] = {17297280.0, 8648640.0, 1995840.0, 277200.0,
+                             25200.0,    1512.0,    56.0,      1.0};
+constexpr double kPade9[] = {17643225600.0, 8821612800.0, 2075673600.0,
+                             302702400.0,   30270240.0,   2162160.0,
+                             110880.0,      3960.0,       90.0,
+                             1.0};
+constexpr double kPade13[] = {
+    64764752532480000.0, 32382376266240000.0, 7771770303897600.0,
+    1187353796428800.0,  129060195264000.0,   10559470521600.0,
+    670442572800.0,      33522128640.0,       1323241920.0,
+    40840800.0,          960960.0,            16380.0,
+    182.0,               1.0};
+constexpr const double* kPadeCoefficients[] = {kPade3, kPade5, kPade7, kPade9,
+                                               kPade13};
+
+// r_m(A) = (V - U)^-1 (V + U), где U — нечётная часть числителя, V —
+// чётная. Для m = 13 старшие слагаемые вычисляются по схеме Горнера
+// через A^6, поэтому хватает степеней A^2, A^4, A^6
+S21Matrix S21Matrix::Exp() const {
+  if (rows_ != cols_) {
+    throw logic_error("Матрица не квадратная");
+  }
+
+  const double norm = Norm1();
+  if (!isfinite(norm)) {
+    throw invalid_argument("Матрица содержит бесконечные элементы");
+  }
+
+  int index = 0;
+  while (index < 4 && norm > kPadeTheta[index]) index++;
+  const int m = kPadeDegrees[index];
+  const double* b = kPadeCoefficients[index];
+
+  const int n = rows_;
+  S21Matrix a(*this);
+  int squarings = 0;
+  if (norm > kPadeTheta[4]) {
+    squarings = static_cast<int>(ceil(log2(norm / kPadeTheta[4])));
+    a.Scale(ldexp(1.0, -squarings));
+  }
+
+  const int count = m == 13 ? 3 : (m - 1) / 2;
+  vector<S21Matrix> powers;
+  powers.reserve(count);
+  powers.emplace_back(n, n);
+  powers[0].Gemm(1.0, a, a, 0.0);
+  for (int p = 1; p < count; p++) {
+    powers.emplace_back(n, n);
+    powers[p].Gemm(1.0, powers[p - 1], powers[0], 0.0);
+  }
+
+  S21Matrix odd(n, n), even(n, n);
+  for (int i = 0; i < n; i++) {
+    odd.Row(i)[i] = b[1];
+    even.Row(i)[i] = b[0];
+  }
+  for (int p = 0; p < count; p++) {
+    odd.AddScaled(b[2 * p + 3], powers[p]);
+    even.AddScaled(b[2 * p + 2], powers[p]);
+  }
+  if (m == 13) {
+    S21Matrix high_odd(n, n), high_even(n, n);
+    for (int p = 0; p < count; p++) {
+      high_odd.AddScaled(b[2 * p + 9], powers[p]);
+      high_even.AddScaled(b[2 * p + 8], powers[p]);
+    }
+    odd.Gemm(1.0, powers[2], high_odd, 1.0);
+    even.Gemm(1.0, powers[2], high_even, 1.0);
+  }
+
+  // powers больше не нужны: A^2 служит буфером для U и возведения в квадрат
+  S21Matrix& u = powers[0];
+  u.Gemm(1.0, a, odd, 0.0);
+  S21Matrix denominator = even;
+  denominator -= u;
+  even += u;
+
+  S21Matrix result = denominator.Solve(even);
+  for (int s = 0; s < squarings; s++) {
+    u.Gemm(1.0, result, result, 0.0);
+    swap(result, u);
+  }
+  return result;
+}
+
+// Ширина панели блочного QR: отражения панели накапливаются в
+// компактную WY-форму I - V T V^T и применяются к остальным столбцам
+// одним проходом по строкам
+constexpr int kQrBlock = 32;
+// Высота блока строк TSQR
+constexpr int kTsqrBlockRows = 1024;
+
+// QR-разложение отражениями Хаусхолдера на месте, как LAPACK dgeqrf:
+// R остаётся в верхнем треугольнике, вектор отражения k (с неявной
+// единицей на диагонали) — под диагональю столбца k, множитель — в tau[k].
+// Панели по kQrBlock столбцов раскладываются без блоков, остальные
+// столбцы обновляются блочным отражением
+void S21Matrix::HouseholderQr(vector<double>& tau) {
+  PrepareWrite();
+  const int steps = min(rows_, cols_);
+  tau.assign(steps, 0.0);
+
+  for (int k = 0; k < steps; k += kQrBlock) {
+    const int count = min(kQrBlock, steps - k);
+    HouseholderColumns(k, k + count, tau.data());
+    if (k + count < cols_) {
+      ApplyReflectors(*this, k, count, tau.data(), *this, k + count, true);
+    }
+  }
+}
+
+// Отражения для столбцов [begin, end), применяемые только к ним же.
+// Матрица хранится по строкам, поэтому отражение применяется двумя
+// проходами по строкам: w = v^T A, затем A -= tau v w
+void S21Matrix::HouseholderColumns(int begin, int end, double* tau) {
+  const int m = rows_;
+  vector<double> w(end);
+
+  for (int k = begin; k < min(end, m); k++) {
+    double below = 0.0;
+    for (int i = k + 1; i < m; i++) below += Row(i)[k] * Row(i)[k];
+    if (below == 0.0) continue;
+
+    const double alpha = Row(k)[k];
+    const double beta = -copysign(sqrt(alpha * alpha + below), alpha);
+    const double scale = 1.0 / (alpha - beta);
+    for (int i = k + 1; i < m; i++) Row(i)[k] *= scale;
+    tau[k] = (beta - alpha) / beta;
+    Row(k)[k] = beta;
+
+    copy(Row(k) + k + 1, Row(k) + end, w.begin() + k + 1);
+    for (int i = k + 1; i < m; i++) {
+      const double* row = Row(i);
+      for (int c = k + 1; c < end; c++) w[c] += row[k] * row[c];
+    }
+    for (int c = k + 1; c < end; c++) Row(k)[c] -= tau[k] * w[c];
+    for (int i = k + 1; i < m; i++) {
+      double* row = Row(i);
+      const double factor = tau[k] * row[k];
+      for (int c = k + 1; c < end; c++) row[c] -= factor * w[c];
+    }
+  }
+}
+
+// target(k:, begin:) = (I - V op(T) V^T) target(k:, begin:) для отражений
+// k..k + count - 1 из packed, op(T) = T^T при transposed (применение Q^T).
+// T строится как в LAPACK dlarft по матрице Грама V^T V. Потоки делят
+// столбцы target, поэтому target может совпадать с packed, если begin
+// правее панели
+void S21Matrix::ApplyReflectors(const S21Matrix& packed, int k, int count,
+                                const double* tau, S21Matrix& target,
+                                int begin, bool transposed) {
+  const int m = packed.rows_;
+  // Строка r матрицы V: неявная единица в столбце r - k, нули правее
+  auto v_row = [&packed, k, count](int r, double* v) {
+    for (int j = 0; j < count; j++) {
+      v[j] = r == k + j ? 1.0 : r > k + j ? packed.Row(r)[k + j] : 0.0;
+    }
+  };
+
+  vector<double> gram(static_cast<size_t>(count) * count, 0.0);
+  vector<double> v(count);
+  for (int r = k; r < m; r++) {
+    v_row(r, v.data());
+    for (int i = 0; i < count; i++) {
+      for (int j = i + 1; j < count; j++) gram[i * count + j] += v[i] * v[j];
+    }
+  }
+
+  vector<double> t(static_cast<size_t>(count) * count, 0.0);
+  for (int j = 0; j < count; j++) {
+    for (int i = 0; i < j; i++) {
+      double sum = 0.0;
+      for (int p = i; p < j; p++) sum += t[i * count + p] * gram[p * count + j];
+      t[i * count + j] = -tau[k + j] * sum;
+    }
+    t[j * count + j] = tau[k + j];
+  }
+
+  const int width = target.cols_ - begin;
+  const size_t work = static_cast<size_t>(m - k) * count * width;
+  S21ParallelFor(width, work, [&](int first, int last) {
+    const int span = last - first;
+    vector<double> w(static_cast<size_t>(count) * span, 0.0);
+    vector<double> vr(count);
+
+    for (int r = k; r < m; r++) {
+      v_row(r, vr.data());
+      const double* row = target.Row(r) + begin + first;
+      for (int j = 0; j < count; j++) {
+        if (vr[j] == 0.0) continue;
+        double* wj = w.data() + static_cast<size_t>(j) * span;
+        for (int c = 0; c < span; c++) wj[c] += vr[j] * row[c];
+      }
+    }
+
+    // w = op(T) w на месте: T^T нижнетреугольная — строки с конца,
+    // T верхнетреугольная — с начала
+    for (int step = 0; step < count; step++) {
+      const int i = transposed ? count - 1 - step : step;
+      double* wi = w.data() + static_cast<size_t>(i) * span;
+      const int lo = transposed ? 0 : i, hi = transposed ? i + 1 : count;
+      for (int c = 0; c < span; c++) {
+        double value = 0.0;
+        for (int j = lo; j < hi; j++) {
+          const double tij = transposed ? t[j * count + i] : t[i * count + j];
+          value += tij * w[static_cast<size_t>(j) * span + c];
+        }
+        wi[c] = value;
+      }
+    }
+
+    for (int r = k; r < m; r++) {
+      v_row(r, vr.data());
+      double* row = target.Row(r) + begin + first;
+      for (int j = 0; j < count; j++) {
+        if (vr[j] == 0.0) continue;
+        const double* wj = w.data() + static_cast<size_t>(j) * span;
+        for (int c = 0; c < span; c++) row[c] -= vr[j] * wj[c];
+      }
+    }
+  });
+}
+
+// Первые min(rows, cols) столбцов Q = H_0 H_1 ... по упакованным
+// отражениям; блоки отражений применяются к единичной матрице с конца.
+// Столбцы левее k в строках ниже k ещё нулевые и не затрагиваются
+S21Matrix S21Matrix::HouseholderQ(const vector<double>& tau) const {
+  const int steps = static_cast<int>(tau.size());
+  S21Matrix q(rows_, steps);
+  for (int i = 0; i < steps; i++) q.Row(i)[i] = 1.0;
+
+  for (int k = (steps - 1) / kQrBlock * kQrBlock; k >= 0; k -= kQrBlock) {
+    const int count = min(kQrBlock, steps - k);
+    ApplyReflectors(*this, k, count, tau.data(), q, k, false);
+  }
+  return q;
+}
+
+// R-множитель QR высокой матрицы деревом TSQR (Demmel и др., 2012):
+// блоки строк раскладываются независимо, затем пары треугольников R
+// ставятся друг на друга и раскладываются снова. Q не строится. Каждый
+// блок не ниже cols строк, поэтому все R имеют размер cols x cols
+S21Matrix S21Matrix::TsqrR() const {
+  const int m = rows_, n = cols_;
+  const int blocks = max(1, m / max(kTsqrBlockRows, 2 * n));
+
+  auto reduce = [n](S21Matrix& block) {
+    vector<double> tau;
+    block.HouseholderQr(tau);
+    block.SetRows(n);
+    for (int i = 1; i < n; i++) fill(block.Row(i), block.Row(i) + i, 0.0);
+  };
+
+  vector<S21Matrix> factors(blocks);
+  const size_t work = static_cast<size_t>(m) * n * n;
+  S21ParallelFor(blocks, work, [&](int begin, int end) {
+    for (int b = begin; b < end; b++) {
+      const int first =
+          static_cast<int>(static_cast<long long>(b) * m / blocks);
+      const int last =
+          static_cast<int>(static_cast<long long>(b + 1) * m / blocks);
+      S21Matrix block(last - first, n);
+      for (int i = first; i < last; i++) {
+        copy(Row(i), Row(i) + n, block.Row(i - first));
+      }
+      reduce(block);
+      factors[b] = std::move(block);
+    }
+  });
+
+  while (factors.size() > 1) {
+    const int pairs = static_cast<int>(factors.size() / 2);
+    vector<S21Matrix> next((factors.size() + 1) / 2);
+    S21ParallelFor(pairs, static_cast<size_t>(pairs) * 2 * n * n * n,
+                   [&](int begin, int end) {
+                     for (int p = begin; p < end; p++) {
+                       S21Matrix stacked(2 * n, n);
+                       factors[2 * p].CopyTo(stacked.Row(0), n);
+                       factors[2 * p + 1].CopyTo(stacked.Row(n), n);
+                       reduce(stacked);
+                       next[p] = std::move(stacked);
+                     }
+                   });
+    if (factors.size() % 2 == 1) next.back() = std::move(factors.back());
+    factors = std::move(next);
+  }
+  return std::move(factors[0]);
+}
+
+pair<S21Matrix, S21Matrix> S21Matrix::Qr() const {
+  if (rows_ == 0 || cols_ == 0) {
+    throw logic_error("Матрица пустая");
+  }
+
+  S21Matrix packed(*this);
+  vector<double> tau;
+  packed.HouseholderQr(tau);
+
+  const int k = static_cast<int>(tau.size());
+  S21Matrix r(k, cols_);
+  for (int i = 0; i < k; i++) {
+    copy(packed.Row(i) + i, packed.Row(i) + cols_, r.Row(i) + i);
+  }
+  return {packed.HouseholderQ(tau), std::move(r)};
+}
+
+// QR матрицы [A | B] даёт R и Q^T B одновременно: верхние cols строк
+// правой части R — это Q^T B, дальше остаётся обратная подстановка
+S21Matrix S21Matrix::LeastSquares(const S21Matrix& b) const {
+  if (b.rows_ != rows_ || b.cols_ <= 0) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+  if (rows_ < cols_) {
+    throw logic_error("Уравнений меньше, чем неизвестных");
+  }
+
+  const int n = cols_, width = cols_ + b.cols_;
+  S21Matrix augmented(rows_, width);
+  for (int i = 0; i < rows_; i++) {
+    copy(Row(i), Row(i) + n, augmented.Row(i));
+    copy(b.Row(i), b.Row(i) + b.cols_, augmented.Row(i) + n);
+  }
+
+  S21Matrix r;
+  if (rows_ >= 2 * kTsqrBlockRows && rows_ >= 4 * width) {
+    r = augmented.TsqrR();
+  } else {
+    vector<double> tau;
+    augmented.HouseholderQr(tau);
+    r = std::move(augmented);
+  }
+
+  double largest = 0.0;
+  for (int i = 0; i < n; i++) largest = max(largest, fabs(r.Row(i)[i]));
+  const double tolerance =
+      largest * max(rows_, cols_) * numeric_limits<double>::epsilon();
+
+  S21Matrix x(n, b.cols_);
+  for (int i = n - 1; i >= 0; i--) {
+    const double* r_row = r.Row(i);
+    if (!(fabs(r_row[i]) > tolerance)) {
+      throw logic_error("Столбцы матрицы линейно зависимы");
+    }
+
+    double* x_row = x.Row(i);
+    copy(r_row + n, r_row + width, x_row);
+    for (int j = i + 1; j < n; j++) {
+      const double* solved = x.Row(j);
+      for (int c = 0; c < b.cols_; c++) x_row[c] -= r_row[j] * solved[c];
+    }
+    for (int c = 0; c < b.cols_; c++) x_row[c] /= r_row[i];
+  }
+  return x;
+}
+
+// Диапазон A ищется по образу гауссовой матрицы Omega, power_iterations
+// проходов (A A^T)^q уточняют его для медленно убывающего спектра. Малая
+// матрица B = Q^T A размера l x cols раскладывается односторонним методом
+// Якоби по строкам: вращения J делают строки W = J^T B ортогональными,
+// тогда B = J W, сингулярные числа — нормы строк W
+tuple<S21Matrix, S21Matrix, S21Matrix> S21Matrix::RandomizedSvd(
+    int rank, int oversampling, int power_iterations, unsigned seed) const {
+  if (rank <= 0 || rank > min(rows_, cols_)) {
+    throw invalid_argument("Ранг должен быть от 1 до меньшей из размерностей");
+  }
+  if (oversampling < 0 || power_iterations < 0) {
+    throw invalid_argument(
+        "Запас и число итераций не могут быть отрицательными");
+  }
+
+  const int m = rows_, n = cols_;
+  const int l = min(rank + oversampling, min(m, n));
+
+  mt19937_64 generator(seed);
+  normal_distribution<double> gaussian;
+  S21Matrix omega(n, l);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < l; j++) omega.Row(i)[j] = gaussian(generator);
+  }
+
+  // Ортонормированный базис столбцов y; y портится
+  vector<double> tau;
+  auto orthonormalize = [&tau](S21Matrix& y) {
+    y.HouseholderQr(tau);
+    return y.HouseholderQ(tau);
+  };
+
+  S21Matrix sample(m, l), back(n, l);
+  sample.Gemm(1.0, *this, omega, 0.0);
+  S21Matrix q = orthonormalize(sample);
+  for (int iteration = 0; iteration < power_iterations; iteration++) {
+    back.Gemm(1.0, Transposed(), q, 0.0);
+    const S21Matrix basis = orthonormalize(back);
+    sample.Gemm(1.0, *this, basis, 0.0);
+    q = orthonormalize(sample);
+  }
+
+  S21Matrix w(l, n), jt(l, l);
+  w.Gemm(1.0, q.Transposed(), *this, 0.0);
+  for (int i = 0; i < l; i++) jt.Row(i)[i] = 1.0;
+
+  auto rotate = [](double* x, double* y, int size, double c, double s) {
+    for (int t = 0; t < size; t++) {
+      const double xt = x[t], yt = y[t];
+      x[t] = c * xt - s * yt;
+      y[t] = s * xt + c * yt;
+    }
+  };
+  const double eps = numeric_limits<double>::epsilon();
+  for (int sweep = 0, rotated = 1; sweep < 60 && rotated; sweep++) {
+    rotated = 0;
+    for (int i = 0; i < l; i++) {
+      for (int j = i + 1; j < l; j++) {
+        const double alpha = Dot(w.Row(i), w.Row(i), n);
+        const double beta = Dot(w.Row(j), w.Row(j), n);
+        const double gamma = Dot(w.Row(i), w.Row(j), n);
+        if (fabs(gamma) <= eps * sqrt(alpha * beta)) continue;
+
+        const double zeta = (beta - alpha) / (2.0 * gamma);
+        const double t =
+            copysign(1.0, zeta) / (fabs(zeta) + sqrt(1.0 + zeta * zeta));
+        const double c = 1.0 / sqrt(1.0 + t * t);
+        rotate(w.Row(i), w.Row(j), n, c, c * t);
+        rotate(jt.Row(i), jt.Row(j), l, c, c * t);
+        rotated = 1;
+      }
+    }
+  }
+
+  vector<double> sigma(l);
+  for (int i = 0; i < l; i++) sigma[i] = sqrt(Dot(w.Row(i), w.Row(i), n));
+  vector<int> order(l);
+  iota(order.begin(), order.end(), 0);
+  stable_sort(order.begin(), order.end(),
+              [&sigma](int x, int y) { return sigma[x] > sigma[y]; });
+
+  // U = Q J по отобранным столбцам J, V — нормированные строки W
+  S21Matrix selected(rank, l), s(rank, 1), v(n, rank);
+  for (int r = 0; r < rank; r++) {
+    const int i = order[r];
+    copy(jt.Row(i), jt.Row(i) + l, selected.Row(r));
+    s.Row(r)[0] = sigma[i];
+    const double inverse = sigma[i] > 0.0 ? 1.0 / sigma[i] : 0.0;
+    for (int c = 0; c < n; c++) v.Row(c)[r] = w.Row(i)[c] * inverse;
+  }
+  S21Matrix u(m, rank);
+  u.Gemm(1.0, q, selected.Transposed(), 0.0);
+  return {std::move(u), std::move(s), std::move(v)};
+}
+
+// Решение систем A X = B, столбцы B решаются независимо
+S21Matrix S21Matrix::Solve(const S21Matrix& b, SolveMode mode) const {
+  return SolveImpl(b, mode, false);
+}
+
+S21Matrix::TransposedView S21Matrix::Transposed() const {
+  return TransposedView(*this);
+}
+
+// transposed — решается A^T X = B
+S21Matrix S21Matrix::SolveImpl(const S21Matrix& b, SolveMode mode,
+                               bool transposed) const {
+  if (rows_ != cols_) {
+    throw logic_error("Матрица не квадратная");
+  }
+  if (b.rows_ != rows_ || b.cols_ <= 0) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+
+  S21Matrix x(rows_, b.cols_);
+  if (mode == SolveMode::kMixed && SolveMixed(b, x, transposed)) {
+    return x;
+  }
+  return SolveDouble(b, transposed);
+}
+
+// r = b - op(A) x в double
+void S21Matrix::Residual(const double* x, const double* b, double* r,
+                         bool transposed) const {
+  const size_t work = static_cast<size_t>(rows_) * cols_;
+  if (!transposed) {
+    S21ParallelFor(rows_, work, [&](int begin, int end) {
+      for (int i = begin; i < end; i++) r[i] = b[i] - Dot(Row(i), x, cols_);
+    });
+    return;
+  }
+
+  S21ParallelFor(cols_, work, [&](int begin, int end) {
+    copy(b + begin, b + end, r + begin);
+    for (int k = 0; k < rows_; k++) {
+      const double xk = x[k];
+      const double* row = Row(k);
+      for (int i = begin; i < end; i++) r[i] -= row[i] * xk;
+    }
+  });
+}
+
+// Копирует квадратную матрицу (или её транспонированную) в плотный буфер
+// n x n для LU-разложения
+template <typename T>
+void S21Matrix::CopySquare(T* target, bool transposed) const {
+  const int n = rows_;
+  for (int i = 0; i < n; i++) {
+    const double* row = Row(i);
+    for (int j = 0; j < n; j++) {
+      const size_t index = transposed ? static_cast<size_t>(j) * n + i
+                                      : static_cast<size_t>(i) * n + j;
+      target[index] = static_cast<T>(row[j]);
+    }
+  }
+}
+
+// A X = B и A^T X = B решаются по одному разложению A из кэша
+S21Matrix S21Matrix::SolveDouble(const S21Matrix& b,
+                                 bool transposed) const {
+  unique_ptr<Factorization> uncached;
+  const Factorization& factorization = Factorize(uncached);
+  if (factorization.singular) {
+    throw logic_error("Матрица вырожденная, решения не сущестсвует");
+  }
+
+  const int n = rows_;
+  const double* lu = factorization.lu.data();
+  const int* pivots = factorization.pivots.data();
+
+  S21Matrix x(n, b.cols_);
+  vector<double> column(n);
+  for (int c = 0; c < b.cols_; c++) {
+    for (int i = 0; i < n; i++) column[i] = b.Row(i)[c];
+    if (transposed) {
+      LuSolveTransposed(lu, n, pivots, column.data());
+    } else {
+      LuSolve(lu, n, pivots, column.data());
+    }
+    for (int i = 0; i < n; i++) x.Row(i)[c] = column[i];
+  }
+  return x;
+}
+
+// Разложение во float и итерационное уточнение в double, как в LAPACK
+// dsgesv. Возвращает false, если уточнение не сошлось
+bool S21Matrix::SolveMixed(const S21Matrix& b, S21Matrix& x,
+                           bool transposed) const {
+  const int n = rows_;
+  const int max_iterations = 30;
+  vector<float> lu(static_cast<size_t>(n) * n);
+  vector<int> pivots(n);
+  CopySquare(lu.data(), transposed);
+
+  if (!LuFactor(lu.data(), n, pivots.data(), numeric_limits<float>::min())) {
+    return false;
+  }
+
+  const double tolerance = FrobeniusNorm() *
+                           numeric_limits<double>::epsilon() * sqrt(double(n));
+  vector<double> rhs(n), solution(n), residual(n);
+  vector<float> correction(n);
+
+  for (int c = 0; c < b.cols_; c++) {
+    for (int i = 0; i < n; i++) {
+      rhs[i] = b.Row(i)[c];
+      correction[i] = static_cast<float>(rhs[i]);
+    }
+    LuSolve(lu.data(), n, pivots.data(), correction.data());
+    copy(correction.begin(), correction.end(), solution.begin());
+
+    bool converged = false;
+    for (int iteration = 0; iteration <= max_iterations; iteration++) {
+      Residual(solution.data(), rhs.data(), residual.data(), transposed);
+
+      double residual_norm = 0.0, solution_norm = 0.0;
+      for (int i = 0; i < n; i++) {
+        residual_norm += residual[i] * residual[i];
+        solution_norm += solution[i] * solution[i];
+      }
+      if (!isfinite(residual_norm)) break;
+      if (sqrt(residual_norm) <= sqrt(solution_norm) * tolerance) {
+        converged = true;
+        break;
+      }
+
+      for (int i = 0; i < n; i++) {
+        correction[i] = static_cast<float>(residual[i]);
+      }
+      LuSolve(lu.data(), n, pivots.data(), correction.data());
+      for (int i = 0; i < n; i++) solution[i] += correction[i];
+    }
+
+    if (!converged) return false;
+    for (int i = 0; i < n; i++) x.Row(i)[c] = solution[i];
+  }
+  return true;
+}
+
+// Строки [begin, end) для Gemm. Без транспонирования b порядок i-k-j,
+// иначе элемент — скалярное произведение строки op(a) на непрерывную
+// строку b; столбец a при trans_a собирается в буфер
+void S21Matrix::GemmRows(double alpha, const S21Matrix& a, bool trans_a,
+                         const S21Matrix& b, bool trans_b, double beta,
+                         int begin, int end) {
+  const int inner = trans_a ? a.rows_ : a.cols_;
+  vector<double> gathered(trans_a && trans_b ? inner : 0);
+
+  for (int i = begin; i < end; i++) {
+    double* row = Row(i);
+    if (beta == 0.0) {
+      fill(row, row + cols_, 0.0);
+    } else if (beta != 1.0) {
+      for (int j = 0; j < cols_; j++) row[j] *= beta;
+    }
+
+    if (!trans_b) {
+      for (int k = 0; k < inner; k++) {
+        const double aik = alpha * (trans_a ? a.Row(k)[i] : a.Row(i)[k]);
+        const double* b_row = b.Row(k);
+        for (int j = 0; j < cols_; j++) {
+          row[j] += aik * b_row[j];
+        }
+      }
+      continue;
+    }
+
+    const double* a_row = a.Row(i);
+    if (trans_a) {
+      for (int k = 0; k < inner; k++) gathered[k] = a.Row(k)[i];
+      a_row = gathered.data();
+    }
+    for (int j = 0; j < cols_; j++) {
+      row[j] += alpha * Dot(a_row, b.Row(j), inner);
+    }
+  }
+}
+
+// Классическая задача о порядке умножения матриц: cost[i][j] — минимальное
+// число умножений для chain[i..j]
+S21Matrix S21Matrix::MultiplyChain(
+    initializer_list<reference_wrapper<const S21Matrix>> factors) {
+  if (factors.size() == 0) {
+    throw invalid_argument("Пустая цепочка матриц");
+  }
+
+  vector<const S21Matrix*> chain;
+  for (const S21Matrix& factor : factors) chain.push_back(&factor);
+  for (size_t k = 0; k + 1 < chain.size(); k++) {
+    if (chain[k]->cols_ != chain[k + 1]->rows_) {
+      throw invalid_argument(
+          "Столбцы в первой матрице не должны быть равными строкам во второй");
+    }
+  }
+
+  const int n = static_cast<int>(chain.size());
+  if (n == 1) return *chain[0];
+
+  // Размеры: chain[k] имеет dims[k] x dims[k + 1]
+  vector<double> dims(n + 1);
+  for (int k = 0; k < n; k++) dims[k] = chain[k]->rows_;
+  dims[n] = chain[n - 1]->cols_;
+
+  const size_t cells = static_cast<size_t>(n) * n;
+  vector<double> cost(cells, 0.0);
+  vector<int> split(cells, 0);
+  for (int length = 2; length <= n; length++) {
+    for (int i = 0; i + length <= n; i++) {
+      const int j = i + length - 1;
+      const size_t ij = static_cast<size_t>(i) * n + j;
+      cost[ij] = numeric_limits<double>::infinity();
+      for (int s = i; s < j; s++) {
+        const double c = cost[static_cast<size_t>(i) * n + s] +
+                         cost[static_cast<size_t>(s + 1) * n + j] +
+                         dims[i] * dims[s + 1] * dims[j + 1];
+        if (c < cost[ij]) {
+          cost[ij] = c;
+          split[ij] = s;
+        }
+      }
+    }
+  }
+
+  S21Matrix result(chain.front()->rows_, chain.back()->cols_);
+  ChainEvaluator(chain, split).Multiply(0, n - 1, result);
+  return result;
+}
+
+// Асинхронные операции
+void S21AsyncControl::Checkpoint(double progress) {
+  progress_.store(progress);
+  if (stop_.stop_requested()) {
+    throw S21OperationCancelled();
+  }
+}
+
+future<S21Matrix> S21Matrix::MulAsync(
+    const S21Matrix& other, shared_ptr<S21AsyncControl> control) const {
+  if (cols_ != other.rows_) {
+    throw invalid_argument(
+        "Столбцы в первой матрице не должны быть равными строкам во второй");
+  }
+  if (!control) control = make_shared<S21AsyncControl>();
+
+  return AsyncExecutor::Instance().Submit([a = *this, b = other, control]() {
+    S21Matrix result(a.rows_, b.cols_);
+    const size_t row_work = static_cast<size_t>(a.cols_) * b.cols_;
+    // Между проверками отмены выполняется около 2^22 умножений
+    const int block = static_cast<int>(
+        max<size_t>(1, (size_t(1) << 22) / max<size_t>(row_work, 1)));
+
+    for (int begin = 0; begin < a.rows_; begin += block) {
+      control->Checkpoint(static_cast<double>(begin) / a.rows_);
+      const int end = min(a.rows_, begin + block);
+      S21ParallelFor(end - begin, row_work * (end - begin),
+                     [&](int first, int last) {
+                       result.GemmRows(1.0, a, false, b, false, 0.0,
+                                       begin + first, begin + last);
+                     });
+    }
+
+    control->progress_.store(1.0);
+    return result;
+  });
+}
+
+future<double> S21Matrix::DeterminantAsync(
+    shared_ptr<S21AsyncControl> control) const {
+  if (rows_ != cols_) {
+    throw logic_error("Матрица не квадратная");
+  }
+  if (!control) control = make_shared<S21AsyncControl>();
+
+  return AsyncExecutor::Instance().Submit([a = *this, control]() mutable {
+    control->Checkpoint(0.0);
+    const int n = a.rows_;
+    double determinant = 0.0;
+
+    if (n <= 4) {
+      determinant = a.Determinant();
+    } else {
+      vector<double> lu(static_cast<size_t>(n) * n);
+      vector<int> pivots(n);
+      a.CopyTo(lu.data(), n);
+
+      auto step = [&](int k) { control->Checkpoint(double(k + 1) / n); };
+      if (LuFactor(lu.data(), n, pivots.data(), kSingularPivot, step)) {
+        determinant = LuDeterminant(lu.data(), n, pivots.data());
+      }
+    }
+
+    control->progress_.store(1.0);
+    return determinant;
+  });
+}
+
+future<S21Matrix> S21Matrix::InverseAsync(
+    shared_ptr<S21AsyncControl> control) const {
+  if (rows_ != cols_) {
+    throw logic_error("Матрица не квадратная");
+  }
+  if (!control) control = make_shared<S21AsyncControl>();
+
+  return AsyncExecutor::Instance().Submit([a = *this, control]() mutable {
+    control->Checkpoint(0.0);
+    const int n = a.rows_;
+
+    if (n <= 4) {
+      S21Matrix result = a.InverseMatrix();
+      control->progress_.store(1.0);
+      return result;
+    }
+
+    // Первая половина прогресса — разложение, вторая — подстановки
+    vector<double> lu(static_cast<size_t>(n) * n);
+    vector<int> pivots(n);
+    a.CopyTo(lu.data(), n);
+
+    auto step = [&](int k) { control->Checkpoint(0.5 * (k + 1) / n); };
+    if (!LuFactor(lu.data(), n, pivots.data(), kSingularPivot, step)) {
+      throw logic_error("Матрица вырожденная, обратной не сущестсвует");
+    }
+
+    // Новая матрица n x n хранится плотно, строки идут подряд
+    S21Matrix result(n, n);
+    LuInvert(lu.data(), n, pivots.data(), result.Row(0),
+             [&](int c) { control->Checkpoint(0.5 + 0.5 * c / n); });
+
+    control->progress_.store(1.0);
+    return result;
+  });
+}
+
+// Перегрузка операторов
+
+S21Matrix& S21Matrix::operator=(const S21Matrix& other) {
+  if (this == &other) return *this;
+
+  if (other.refs_) {
+    other.refs_->fetch_add(1);
+    Release();
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    row_cap_ = other.row_cap_;
+    stride_ = other.stride_;
+    matrix_ = other.matrix_;
+    refs_ = other.refs_;
+    exposed_ = other.exposed_;
+  } else if (other.matrix_ == nullptr) {
+    Release();
+  } else if (static_cast<size_t>(other.rows_) * other.cols_ > kSmallSize) {
+    double* block = new double[static_cast<size_t>(other.rows_) * other.cols_];
+    other.CopyTo(block, other.cols_);
+    cow_ = other.cow_;
+    Adopt(block, other.rows_, other.cols_, other.rows_, other.cols_);
+  } else {
+    Release();
+    other.CopyTo(small_, other.cols_);
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    row_cap_ = other.rows_;
+    stride_ = other.cols_;
+    matrix_ = small_;
+  }
+
+  cow_ = other.cow_;
+  return *this;
+}
+
+S21Matrix& S21Matrix::operator=(S21Matrix&& other) noexcept {
+  if (this == &other) return *this;
+
+  Release();
+  rows_ = other.rows_;
+  cols_ = other.cols_;
+  row_cap_ = other.row_cap_;
+  stride_ = other.stride_;
+  cow_ = other.cow_;
+  external_ = other.external_;
+  read_only_ = other.read_only_;
+  exposed_ = other.exposed_;
+  factorization_.store(other.factorization_.exchange(nullptr));
+
+  if (other.IsInline()) {
+    copy(other.small_, other.small_ + static_cast<size_t>(row_cap_) * stride_,
+         small_);
+    matrix_ = small_;
+  } else {
+    matrix_ = other.matrix_;
+    refs_ = other.refs_;
+  }
+
+  other.rows_ = 0;
+  other.cols_ = 0;
+  other.row_cap_ = 0;
+  other.stride_ = 0;
+  other.matrix_ = nullptr;
+  other.refs_ = nullptr;
+  other.external_ = false;
+  other.read_only_ = false;
+  other.exposed_ = false;
+  return *this;
+}
+
+S21Matrix S21Matrix::operator+(const S21Matrix& other) {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+
+  S21Matrix temp(*this);
+  temp.SumMatrix(other);
+  return temp;
+}
+
+bool S21Matrix::operator==(const S21Matrix& other) const {
+  return EqMatrix(other);
+}
 
 S21Matrix S21Matrix::operator-(const S21Matrix& other) {
   if (rows_ != other.rows_ || cols_ != other.cols_) {
@@ -414,12 +2327,32 @@ S21Matrix S21Matrix::operator*(const S21Matrix& other) {
 }
 
 S21Matrix operator*(S21Matrix matrix, double i) {
-  S21Matrix temp = matrix;
-  temp.MulNumber(i);
-  return temp;
+  matrix.MulNumber(i);
+  return matrix;
+}
+
+S21Matrix operator*(double i, S21Matrix matrix) {
+  matrix.MulNumber(i);
+  return matrix;
+}
+
+S21Matrix operator*(S21Matrix::TransposedView a, const S21Matrix& b) {
+  S21Matrix result(a.GetRows(), b.GetCols());
+  result.Gemm(1.0, a, b, 0.0);
+  return result;
 }
 
-S21Matrix operator*(double i, S21Matrix matrix) { return matrix * i; }
+S21Matrix operator*(const S21Matrix& a, S21Matrix::TransposedView b) {
+  S21Matrix result(a.GetRows(), b.GetCols());
+  result.Gemm(1.0, a, b, 0.0);
+  return result;
+}
+
+S21Matrix operator*(S21Matrix::TransposedView a, S21Matrix::TransposedView b) {
+  S21Matrix result(a.GetRows(), b.GetCols());
+  result.Gemm(1.0, a, b, 0.0);
+  return result;
+}
 
 S21Matrix& S21Matrix::operator-=(const S21Matrix& other) {
   if (rows_ != other.rows_ || cols_ != other.cols_) {
@@ -445,7 +2378,7 @@ S21Matrix& S21Matrix::operator*=(const S21Matrix& other) {
         "Столбцы в первой матрице не должны быть равными строкам во второй");
   }
 
-  *this = *this * other;
+  MulMatrix(other);
   return *this;
 }
 
@@ -463,7 +2396,8 @@ double& S21Matrix::operator()(int i, int j) {
     throw logic_error("Матрица неинициализирована");
   }
 
-  return matrix_[i][j];
+  PrepareWrite();
+  return Row(i)[j];
 }
 
 const double& S21Matrix::operator()(int i, int j) const {
@@ -475,5 +2409,5 @@ const double& S21Matrix::operator()(int i, int j) const {
     throw logic_error("Матрица неинициализирована");
   }
 
-  return matrix_[i][j];
+  return Row(i)[j];
 }
@@ -1,22 +1,217 @@
 #ifndef S21_MATRIX_OOP_H
 #define S21_MATRIX_OOP_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <exception>
+#include <functional>
+#include <future>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <memory>
+#include <mutex>
+#if __has_include(<mdspan>)
+#include <mdspan>
+#endif
 #include <new>
+#include <span>
 #include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
+// Объём работы (в элементах), начиная с которого ядра распараллеливаются
+inline constexpr size_t kS21ParallelWork = size_t(1) << 16;
+
+// Число аппаратных потоков. Запоминается при первом вызове: в glibc
+// hardware_concurrency каждый раз читает /sys
+inline size_t S21HardwareThreads() {
+  static const size_t threads = max(1u, thread::hardware_concurrency());
+  return threads;
+}
+
+// Делит индексы [0, n) на блоки и вызывает f(begin, end) в нескольких
+// потоках, если work достаточно велик. Исключение из любого блока
+// перехватывается, остальные блоки доводятся до конца, потоки
+// присоединяются, и первое исключение пробрасывается вызывающему
+template <typename F>
+void S21ParallelFor(int n, size_t work, F f) {
+  // Малые задачи выполняются сразу, без единого лишнего вызова
+  if (work < 2 * kS21ParallelWork || n < 2) {
+    f(0, n);
+    return;
+  }
+
+  const size_t threads = min({S21HardwareThreads(), static_cast<size_t>(n),
+                              work / kS21ParallelWork});
+  if (threads <= 1) {
+    f(0, n);
+    return;
+  }
+
+  exception_ptr error;
+  mutex error_mutex;
+  auto run = [&](int begin, int end) {
+    try {
+      f(begin, end);
+    } catch (...) {
+      lock_guard<mutex> lock(error_mutex);
+      if (!error) error = current_exception();
+    }
+  };
+
+  const int chunk = static_cast<int>((n + threads - 1) / threads);
+  vector<thread> pool;
+  pool.reserve(threads - 1);
+
+  // Если поток создать не удалось, оставшиеся блоки выполняет этот поток
+  int begin = chunk;
+  for (; begin < n; begin += chunk) {
+    try {
+      pool.emplace_back(run, begin, min(n, begin + chunk));
+    } catch (const system_error&) {
+      break;
+    }
+  }
+  run(0, chunk);
+  for (; begin < n; begin += chunk) run(begin, min(n, begin + chunk));
+
+  for (thread& worker : pool) {
+    worker.join();
+  }
+  if (error) rethrow_exception(error);
+}
+
+// Исключение, которым завершается отменённая асинхронная операция
+class S21OperationCancelled : public runtime_error {
+ public:
+  S21OperationCancelled() : runtime_error("Операция отменена") {}
+};
+
+// Отмена и прогресс асинхронной операции. Объект разделяется между
+// вызывающим кодом и задачей, прогресс меняется от 0 до 1
+class S21AsyncControl {
+ private:
+  stop_source stop_;
+  atomic<double> progress_{0.0};
+
+  friend class S21Matrix;
+  void Checkpoint(double progress);
+
+ public:
+  void Cancel() { stop_.request_stop(); }
+  bool IsCancelled() const { return stop_.stop_requested(); }
+  double Progress() const { return progress_.load(); }
+};
+
 class S21Matrix {
+ public:
+  // Режим решения систем: kMixed раскладывает матрицу во float и уточняет
+  // решение в double, при неудаче переходя на разложение в double
+  enum class SolveMode { kDouble, kMixed };
+
+  // Транспонированная матрица без копирования, см. Transposed()
+  class TransposedView;
+
+  // Итераторы по элементам в порядке строк, см. begin()
+  template <typename T>
+  class ElementIterator;
+  using iterator = ElementIterator<double>;
+  using const_iterator = ElementIterator<const double>;
+
  private:
   int rows_, cols_;
-  double** matrix_;
+  // Вместимость: строка i начинается с matrix_ + i * stride_,
+  // под буфер выделено row_cap_ * stride_ элементов
+  int row_cap_, stride_;
+  double* matrix_;
+  // Счётчик владельцев буфера в куче в режиме копирования при записи,
+  // nullptr — буфер не разделяется
+  atomic<int>* refs_;
+  bool cow_;
+  // Буфер принадлежит внешнему коду и не освобождается, см. View();
+  // read_only_ — буфер константный, первая запись копирует элементы;
+  // exposed_ — на буфер выдан неконстантный указатель или итератор
+  bool external_, read_only_, exposed_;
+  // Матрицы до kSmallSize элементов хранятся прямо в объекте
+  static constexpr size_t kSmallSize = 16;
+  double small_[kSmallSize];
+  // Кэш LU-разложения, определителя и обратной матрицы. Заполняется
+  // константными запросами и сбрасывается любым изменением матрицы
+  struct Factorization;
+  mutable atomic<Factorization*> factorization_;
+
+  double* Row(int i) const {
+    return matrix_ + static_cast<size_t>(i) * stride_;
+  }
+  bool IsInline() const { return matrix_ == small_; }
+  void CopyTo(double* target, int stride) const;
+  void Release();
+  void Adopt(double* matrix, int rows, int cols, int row_cap, int stride);
+  void Reallocate(int row_cap, int stride);
+  void PrepareWrite();
+  void OwnBuffer();
+  void ClearCache();
+  const Factorization& Factorize(unique_ptr<Factorization>& uncached) const;
+
+  template <typename Op>
+  double ReduceAll(Op op, bool compensated) const;
+  template <typename Op>
+  vector<double> ReduceCols(Op op, bool compensated) const;
+
+  S21Matrix& GemmImpl(double alpha, const S21Matrix& a, bool trans_a,
+                      const S21Matrix& b, bool trans_b, double beta);
+  void GemmRows(double alpha, const S21Matrix& a, bool trans_a,
+                const S21Matrix& b, bool trans_b, double beta, int begin,
+                int end);
+  S21Matrix& GemvImpl(double alpha, const S21Matrix& a, bool trans_a,
+                      const S21Matrix& x, double beta);
+  S21Matrix& SyrkImpl(double alpha, const S21Matrix& a, bool trans,
+                      double beta);
+  void Residual(const double* x, const double* b, double* r,
+                bool transposed) const;
+  S21Matrix SolveImpl(const S21Matrix& b, SolveMode mode,
+                      bool transposed) const;
+  template <typename T>
+  void CopySquare(T* target, bool transposed) const;
+  S21Matrix SolveDouble(const S21Matrix& b, bool transposed) const;
+  bool SolveMixed(const S21Matrix& b, S21Matrix& x, bool transposed) const;
+  void HouseholderQr(vector<double>& tau);
+  void HouseholderColumns(int begin, int end, double* tau);
+  static void ApplyReflectors(const S21Matrix& packed, int k, int count,
+                              const double* tau, S21Matrix& target,
+                              int begin, bool transposed);
+  S21Matrix HouseholderQ(const vector<double>& tau) const;
+  S21Matrix TsqrR() const;
+  template <typename F>
+  S21Matrix& ApplyKernel(F f);
+  template <typename F>
+  S21Matrix& BroadcastRow(const S21Matrix& row, F f);
+  template <typename F>
+  S21Matrix& BroadcastCol(const S21Matrix& col, F f);
 
  public:
   // Базовый конструктор
-  S21Matrix() : rows_(0), cols_(0), matrix_(nullptr) {}
+  S21Matrix()
+      : rows_(0),
+        cols_(0),
+        row_cap_(0),
+        stride_(0),
+        matrix_(nullptr),
+        refs_(nullptr),
+        cow_(false),
+        external_(false),
+        read_only_(false),
+        exposed_(false),
+        factorization_(nullptr) {}
 
   // Параметризированный конструктор
   S21Matrix(int rows, int cols);
@@ -25,21 +220,20 @@ class S21Matrix {
   S21Matrix(const S21Matrix& other);
 
   // Конструктор переноса
-  S21Matrix(S21Matrix&& other);
+  S21Matrix(S21Matrix&& other) noexcept;
 
   // Деструктор
-  ~S21Matrix() {
-    for (int i = 0; i < rows_; i++) {
-      delete[] matrix_[i];
-    }
-    delete[] matrix_;
-  }
+  ~S21Matrix() { Release(); }
 
   // Аксессоры (геттеры)
   int GetRows() const { return rows_; }
 
   int GetCols() const { return cols_; }
 
+  int GetRowsCapacity() const { return row_cap_; }
+
+  int GetColsCapacity() const { return stride_; }
+
   double GetElement(int i, int j) const {
     return (*this)(i, j);
     ;
@@ -50,25 +244,234 @@ class S21Matrix {
   void SetCols(int new_cols);
   void SetElement(int i, int j, double value);
 
+  // Вместимость: SetRows/SetCols растут геометрически и не перевыделяют
+  // память, пока размер не превышает вместимость
+  void Reserve(int rows, int cols);
+  void AppendRow(span<const double> values);
+
+  // Копирование при записи: копии матрицы делят один буфер, а глубокое
+  // копирование происходит только при первом изменении. Ссылки, полученные
+  // через operator() до создания копии, продолжают указывать в общий буфер
+  void SetCopyOnWrite(bool enabled);
+  bool IsCopyOnWrite() const { return cow_; }
+  bool IsShared() const { return refs_ != nullptr && refs_->load() > 1; }
+
+  // Матрица над внешним буфером без копирования: строка i начинается с
+  // data + i * stride, stride 0 — плотные строки. Буфер должен жить дольше
+  // матрицы, изменения пишутся прямо в него. Для константного буфера
+  // первая запись копирует элементы в собственный буфер, увеличение
+  // размеров — для любого. Копии и присваивания не разделяют внешний
+  // буфер, а копируют элементы. MulMatrix пишет произведение в буфер,
+  // только если число столбцов не меняется, иначе матрица перестаёт быть
+  // представлением. Внешний буфер может меняться в обход матрицы, поэтому
+  // LU-разложение представления не кэшируется
+  static S21Matrix View(double* data, int rows, int cols, int stride = 0);
+  static S21Matrix View(const double* data, int rows, int cols,
+                        int stride = 0);
+  bool IsView() const { return external_; }
+
+  // Прямой доступ: строка i начинается с Data() + i * GetColsCapacity().
+  // Неконстантные Data(), begin(), end() и AsMdspan(), как и operator(),
+  // сначала отделяют общий буфер и сбрасывают кэш. Через выданный
+  // указатель можно писать и после запросов, поэтому дальше LU-разложение
+  // такой матрицы не кэшируется, пока буфер не будет заменён
+  double* Data() {
+    PrepareWrite();
+    exposed_ = true;
+    return matrix_;
+  }
+  const double* Data() const { return matrix_; }
+
+  // Обход элементов по строкам для алгоритмов std и std::ranges; шаг
+  // строки пропускается, итераторы произвольного доступа
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+#ifdef __cpp_lib_mdspan
+  // Элементы как std::mdspan с шагом строки GetColsCapacity()
+  mdspan<double, dextents<size_t, 2>, layout_stride> AsMdspan() {
+    PrepareWrite();
+    exposed_ = true;
+    return {matrix_, {dextents<size_t, 2>(rows_, cols_),
+                      array<size_t, 2>{static_cast<size_t>(stride_), 1}}};
+  }
+  mdspan<const double, dextents<size_t, 2>, layout_stride> AsMdspan() const {
+    return {matrix_, {dextents<size_t, 2>(rows_, cols_),
+                      array<size_t, 2>{static_cast<size_t>(stride_), 1}}};
+  }
+#endif
+
   // Методы
   bool EqMatrix(const S21Matrix& other) const;
   void SumMatrix(const S21Matrix& other);
   void SubMatrix(const S21Matrix& other);
   void MulNumber(const double num);
   void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose();
-  S21Matrix CalcComplements();
-  double Determinant();
-  S21Matrix InverseMatrix();
+  S21Matrix Transpose() const;
+  // Определитель, обратная матрица и Solve для n > 4 используют одно
+  // LU-разложение, которое хранится до первого изменения матрицы (для
+  // представлений и после Data() не хранится, см. выше). Копия
+  // матрицы начинает с пустого кэша. Запись через ссылку, полученную из
+  // operator() до запроса, кэш не сбрасывает. Для n <= 4 определитель и
+  // обратная считаются по явным формулам без кэша; вырожденность
+  // InverseMatrix при любом n определяет по ведущим элементам
+  // LU-разложения (для n <= 4 — временного, на стеке)
+  S21Matrix CalcComplements() const;
+  double Determinant() const;
+  S21Matrix InverseMatrix() const;
+  S21Matrix Solve(const S21Matrix& b,
+                  SolveMode mode = SolveMode::kDouble) const;
+  // Степень квадратной матрицы возведением в квадрат: O(log k) умножений
+  // и три рабочие матрицы. Pow(0) — единичная, при k < 0 возводится в
+  // степень обратная матрица
+  S21Matrix Pow(int k) const;
+  // Матричная экспонента: масштабирование, аппроксимация Паде степени
+  // 3-13 и возведение в квадрат (Higham, 2005)
+  S21Matrix Exp() const;
+
+  // Транспонирование за O(1): представление ссылается на эту матрицу и
+  // принимается Gemm, Gemv и operator* без копирования. Матрица должна
+  // жить дольше представления и не меняться, пока оно используется
+  TransposedView Transposed() const;
+
+  // Составные операции на месте, без временных матриц
+  S21Matrix& Scale(double beta);
+  S21Matrix& AddScaled(double alpha, const S21Matrix& other);
+  S21Matrix& Gemm(double alpha, const S21Matrix& a, const S21Matrix& b,
+                  double beta);
+  S21Matrix& Gemm(double alpha, TransposedView a, const S21Matrix& b,
+                  double beta);
+  S21Matrix& Gemm(double alpha, const S21Matrix& a, TransposedView b,
+                  double beta);
+  S21Matrix& Gemm(double alpha, TransposedView a, TransposedView b,
+                  double beta);
+  // this = alpha * a * x + beta * this для столбцов x и this
+  S21Matrix& Gemv(double alpha, const S21Matrix& a, const S21Matrix& x,
+                  double beta);
+  S21Matrix& Gemv(double alpha, TransposedView a, const S21Matrix& x,
+                  double beta);
+  // Симметричное обновление ранга k: this = alpha * a * a^T + beta * this
+  // (или alpha * a^T * a для представления). Считается только верхний
+  // треугольник, затем он отражается вниз; нижний треугольник this на
+  // входе не читается
+  S21Matrix& SymmetricRankKUpdate(double alpha, const S21Matrix& a,
+                                  double beta);
+  S21Matrix& SymmetricRankKUpdate(double alpha, TransposedView a,
+                                  double beta);
+
+  // Поэлементные преобразования: this(i, j) = f(this(i, j)) и
+  // this(i, j) = f(this(i, j), other(i, j)). f встраивается в цикл по
+  // непрерывной строке, большие матрицы делятся между потоками, поэтому
+  // f не должна иметь разделяемого изменяемого состояния. Малые матрицы
+  // обрабатываются сразу в вызывающем потоке. Исключение из f
+  // пробрасывается вызывающему, матрица остаётся частично изменённой
+  template <typename F>
+  S21Matrix& Apply(F f);
+  template <typename F>
+  S21Matrix& Zip(const S21Matrix& other, F f);
+
+  // Векторизованные exp, log, tanh и сигмоида на месте: AVX2 и FMA
+  // выбираются во время выполнения, иначе используется libm. Ошибка
+  // меньше 3 ULP, см. s21_vector_math.h. SoftmaxRows нормирует каждую
+  // строку: exp(x - max) / сумма
+  S21Matrix& ApplyExp();
+  S21Matrix& ApplyLog();
+  S21Matrix& ApplyTanh();
+  S21Matrix& ApplySigmoid();
+  S21Matrix& SoftmaxRows();
+
+  // Операции с вектором, повторённым по всем строкам (row размера
+  // 1 x cols) или по всем столбцам (col размера rows x 1), за один проход
+  // без временных матриц
+  S21Matrix& AddRowVector(const S21Matrix& row);
+  S21Matrix& AddColVector(const S21Matrix& col);
+  S21Matrix& ScaleRows(const S21Matrix& col);
+  S21Matrix& ScaleCols(const S21Matrix& row);
+  S21Matrix& SubtractColMeans(bool compensated = false);
+
+  // Произведение цепочки матриц. Порядок умножений выбирается
+  // динамическим программированием по числу операций, промежуточные
+  // результаты переиспользуют буферы друг друга
+  static S21Matrix MultiplyChain(
+      initializer_list<reference_wrapper<const S21Matrix>> factors);
+
+  // Асинхронные варианты долгих операций. Операнды копируются в задачу
+  // (в режиме копирования при записи это O(1)), задачи выполняет общий
+  // пул не больше чем из hardware_concurrency потоков, лишние ждут в
+  // очереди. Каждая задача сама распараллеливается через S21ParallelFor.
+  // В отличие от std::async, деструктор future не ждёт завершения
+  // задачи. Отмена через control приводит к исключению
+  // S21OperationCancelled при получении результата
+  future<S21Matrix> MulAsync(
+      const S21Matrix& other,
+      shared_ptr<S21AsyncControl> control = nullptr) const;
+  future<S21Matrix> InverseAsync(
+      shared_ptr<S21AsyncControl> control = nullptr) const;
+  future<double> DeterminantAsync(
+      shared_ptr<S21AsyncControl> control = nullptr) const;
+
+  // Редукции; compensated включает суммирование Ноймайера
+  double Sum(bool compensated = false) const;
+  double FrobeniusNorm(bool compensated = false) const;
+  double Norm1() const;
+  double NormInf() const;
+  double Min() const;
+  double Max() const;
+  pair<int, int> ArgMin() const;
+  pair<int, int> ArgMax() const;
+  S21Matrix RowSums(bool compensated = false) const;
+  S21Matrix ColSums(bool compensated = false) const;
+  S21Matrix ColMeans(bool compensated = false) const;
+  // Матрица Грама столбцов this^T * this и выборочная ковариация
+  // столбцов (строки — наблюдения)
+  S21Matrix Gram() const;
+  S21Matrix Covariance() const;
+
+  // Тонкое QR-разложение блочными отражениями Хаусхолдера: Q размера
+  // rows x k с ортонормированными столбцами и верхнетреугольная R размера
+  // k x cols, k = min(rows, cols)
+  pair<S21Matrix, S21Matrix> Qr() const;
+  // Решение задачи наименьших квадратов min |A X - B| через QR матрицы
+  // [A | B] без нормальных уравнений. Для очень высоких матриц R
+  // считается деревом TSQR по блокам строк, блоки обрабатываются
+  // параллельно
+  S21Matrix LeastSquares(const S21Matrix& b) const;
+
+  // Рандомизированное усечённое SVD (Halko, Martinsson, Tropp, 2011):
+  // A ~ U diag(S) V^T, где U — rows x rank, S — столбец rank x 1 по
+  // убыванию, V — cols x rank. Время O(rows cols l) на каждый проход по
+  // матрице, l = rank + oversampling; плотные разложения только размера
+  // rows x l, cols x l и l x cols
+  tuple<S21Matrix, S21Matrix, S21Matrix> RandomizedSvd(
+      int rank, int oversampling = 10, int power_iterations = 2,
+      unsigned seed = 0) const;
 
   // Перегрузка операторов
   S21Matrix& operator=(const S21Matrix& other);
+  S21Matrix& operator=(S21Matrix&& other) noexcept;
   S21Matrix operator+(const S21Matrix& other);
   bool operator==(const S21Matrix& other) const;
   S21Matrix operator-(const S21Matrix& other);
   S21Matrix operator*(const S21Matrix& other);
   friend S21Matrix operator*(S21Matrix matrix, double i);
   friend S21Matrix operator*(double i, S21Matrix matrix);
+  friend S21Matrix operator*(TransposedView a, const S21Matrix& b);
+  friend S21Matrix operator*(const S21Matrix& a, TransposedView b);
+  friend S21Matrix operator*(TransposedView a, TransposedView b);
+
+  // Тайловые, упакованные, ленточные, разреженные и 16-битные типы и
+  // итерационные решатели работают со строками S21Matrix напрямую
+  friend class S21TiledMatrix;
+  friend class S21TriangularMatrix;
+  friend class S21SymmetricMatrix;
+  friend class S21BandMatrix;
+  friend class S21SparseMatrix;
+  friend class S21ConjugateGradient;
+  friend class S21HalfMatrix;
   S21Matrix& operator+=(const S21Matrix& other);
   S21Matrix& operator-=(const S21Matrix& other);
   S21Matrix& operator*=(const S21Matrix& other);
@@ -77,4 +480,173 @@ class S21Matrix {
   double& operator()(int i, int j);
 };
 
+class S21Matrix::TransposedView {
+ private:
+  const S21Matrix& matrix_;
+
+ public:
+  explicit TransposedView(const S21Matrix& matrix) : matrix_(matrix) {}
+
+  const S21Matrix& Base() const { return matrix_; }
+  int GetRows() const { return matrix_.cols_; }
+  int GetCols() const { return matrix_.rows_; }
+  double operator()(int i, int j) const { return matrix_(j, i); }
+
+  // Копия транспонированной матрицы
+  S21Matrix Materialize() const { return matrix_.Transpose(); }
+  // Решение A^T X = B по LU-разложению A^T, без отдельной копии A^T
+  S21Matrix Solve(const S21Matrix& b,
+                  SolveMode mode = SolveMode::kDouble) const {
+    return matrix_.SolveImpl(b, mode, true);
+  }
+};
+
+// Позиция хранится как (строка, столбец), поэтому ++ и -- не делят, а
+// указатель не выходит за последнюю строку
+template <typename T>
+class S21Matrix::ElementIterator {
+ private:
+  T* data_;
+  ptrdiff_t row_;
+  int col_, cols_, stride_;
+
+  template <typename U>
+  friend class ElementIterator;
+
+ public:
+  using iterator_category = random_access_iterator_tag;
+  using value_type = double;
+  using difference_type = ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
+  ElementIterator() : data_(nullptr), row_(0), col_(0), cols_(1), stride_(0) {}
+  // Для матрицы без столбцов cols = 1 и begin() == end()
+  ElementIterator(T* data, ptrdiff_t row, int cols, int stride)
+      : data_(data), row_(row), col_(0), cols_(max(cols, 1)), stride_(stride) {}
+  // iterator -> const_iterator
+  template <typename U>
+    requires is_convertible_v<U*, T*>
+  ElementIterator(const ElementIterator<U>& other)
+      : data_(other.data_),
+        row_(other.row_),
+        col_(other.col_),
+        cols_(other.cols_),
+        stride_(other.stride_) {}
+
+  T& operator*() const { return data_[row_ * stride_ + col_]; }
+  T* operator->() const { return &**this; }
+  T& operator[](difference_type n) const { return *(*this + n); }
+
+  ElementIterator& operator++() {
+    if (++col_ == cols_) {
+      col_ = 0;
+      row_++;
+    }
+    return *this;
+  }
+  ElementIterator& operator--() {
+    if (col_-- == 0) {
+      col_ = cols_ - 1;
+      row_--;
+    }
+    return *this;
+  }
+  ElementIterator operator++(int) {
+    ElementIterator old = *this;
+    ++*this;
+    return old;
+  }
+  ElementIterator operator--(int) {
+    ElementIterator old = *this;
+    --*this;
+    return old;
+  }
+
+  ElementIterator& operator+=(difference_type n) {
+    const difference_type index = row_ * cols_ + col_ + n;
+    row_ = index / cols_;
+    col_ = static_cast<int>(index % cols_);
+    return *this;
+  }
+  ElementIterator& operator-=(difference_type n) { return *this += -n; }
+  friend ElementIterator operator+(ElementIterator it, difference_type n) {
+    return it += n;
+  }
+  friend ElementIterator operator+(difference_type n, ElementIterator it) {
+    return it += n;
+  }
+  friend ElementIterator operator-(ElementIterator it, difference_type n) {
+    return it -= n;
+  }
+  friend difference_type operator-(const ElementIterator& a,
+                                   const ElementIterator& b) {
+    return (a.row_ - b.row_) * a.cols_ + (a.col_ - b.col_);
+  }
+
+  friend bool operator==(const ElementIterator& a, const ElementIterator& b) {
+    return a.row_ == b.row_ && a.col_ == b.col_;
+  }
+  friend auto operator<=>(const ElementIterator& a, const ElementIterator& b) {
+    return a.row_ != b.row_ ? a.row_ <=> b.row_ : a.col_ <=> b.col_;
+  }
+};
+
+inline S21Matrix::iterator S21Matrix::begin() {
+  PrepareWrite();
+  exposed_ = true;
+  return iterator(matrix_, 0, cols_, stride_);
+}
+
+inline S21Matrix::iterator S21Matrix::end() {
+  PrepareWrite();
+  exposed_ = true;
+  return iterator(matrix_, cols_ > 0 ? rows_ : 0, cols_, stride_);
+}
+
+inline S21Matrix::const_iterator S21Matrix::begin() const {
+  return const_iterator(matrix_, 0, cols_, stride_);
+}
+
+inline S21Matrix::const_iterator S21Matrix::end() const {
+  return const_iterator(matrix_, cols_ > 0 ? rows_ : 0, cols_, stride_);
+}
+
+inline S21Matrix::const_iterator S21Matrix::cbegin() const { return begin(); }
+
+inline S21Matrix::const_iterator S21Matrix::cend() const { return end(); }
+
+template <typename F>
+S21Matrix& S21Matrix::Apply(F f) {
+  PrepareWrite();
+
+  const size_t work = static_cast<size_t>(rows_) * cols_;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* row = Row(i);
+      for (int j = 0; j < cols_; j++) row[j] = f(row[j]);
+    }
+  });
+  return *this;
+}
+
+template <typename F>
+S21Matrix& S21Matrix::Zip(const S21Matrix& other, F f) {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+
+  PrepareWrite();
+
+  const size_t work = static_cast<size_t>(rows_) * cols_;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* row = Row(i);
+      const double* other_row = other.Row(i);
+      for (int j = 0; j < cols_; j++) row[j] = f(row[j], other_row[j]);
+    }
+  });
+  return *this;
+}
+
 #endif
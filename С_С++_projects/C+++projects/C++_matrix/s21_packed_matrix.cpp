@@ -0,0 +1,296 @@
+#include "s21_packed_matrix.h"
+
+// Треугольная матрица
+
+S21TriangularMatrix::S21TriangularMatrix(int size, Part part)
+    : size_(size), part_(part) {
+  if (size <= 0) {
+    throw invalid_argument("Размер матрицы не может быть меньше 0");
+  }
+  data_.assign(static_cast<size_t>(size) * (size + 1) / 2, 0.0);
+}
+
+// Для верхней перед строкой i лежат строки длиной n, n - 1, ..., n - i + 1
+size_t S21TriangularMatrix::Offset(int i, int j) const {
+  if (part_ == Part::kLower) {
+    return static_cast<size_t>(i) * (i + 1) / 2 + j;
+  }
+  return static_cast<size_t>(i) * (2 * size_ - i + 1) / 2 + (j - i);
+}
+
+double S21TriangularMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+  return Stored(i, j) ? data_[Offset(i, j)] : 0.0;
+}
+
+double& S21TriangularMatrix::operator()(int i, int j) {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_ || !Stored(i, j)) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+  return data_[Offset(i, j)];
+}
+
+S21TriangularMatrix S21TriangularMatrix::FromMatrix(const S21Matrix& matrix,
+                                                    Part part) {
+  if (matrix.rows_ != matrix.cols_) {
+    throw logic_error("Матрица не квадратная");
+  }
+
+  S21TriangularMatrix result(matrix.rows_, part);
+  for (int i = 0; i < result.size_; i++) {
+    const double* row = matrix.Row(i);
+    copy(row + result.First(i), row + result.Last(i), result.PackedRow(i));
+  }
+  return result;
+}
+
+S21Matrix S21TriangularMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; i++) {
+    copy(PackedRow(i), PackedRow(i) + (Last(i) - First(i)),
+         result.Row(i) + First(i));
+  }
+  return result;
+}
+
+// Строка i результата — комбинация строк b с хранимыми элементами строки i
+S21Matrix S21TriangularMatrix::Multiply(const S21Matrix& b) const {
+  if (b.rows_ != size_) {
+    throw invalid_argument(
+        "Столбцы в первой матрице не должны быть равными строкам во второй");
+  }
+
+  S21Matrix result(size_, b.cols_);
+  const size_t work = data_.size() * b.cols_;
+  S21ParallelFor(size_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* target = result.Row(i);
+      const double* packed = PackedRow(i);
+      for (int j = First(i); j < Last(i); j++) {
+        const double tij = packed[j - First(i)];
+        const double* b_row = b.Row(j);
+        for (int c = 0; c < b.cols_; c++) target[c] += tij * b_row[c];
+      }
+    }
+  });
+  return result;
+}
+
+// Подстановка по строкам: для нижней сверху вниз, для верхней снизу вверх.
+// Все столбцы правой части обрабатываются одним проходом
+S21Matrix S21TriangularMatrix::Solve(const S21Matrix& b) const {
+  if (b.rows_ != size_ || b.cols_ <= 0) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+
+  S21Matrix x(b);
+  x.PrepareWrite();
+  const bool lower = part_ == Part::kLower;
+  for (int step = 0; step < size_; step++) {
+    const int i = lower ? step : size_ - 1 - step;
+    const double* packed = PackedRow(i);
+    const double diagonal = packed[i - First(i)];
+    if (diagonal == 0.0) {
+      throw logic_error("Матрица вырожденная, решения не сущестсвует");
+    }
+
+    double* target = x.Row(i);
+    for (int j = First(i); j < Last(i); j++) {
+      if (j == i) continue;
+      const double tij = packed[j - First(i)];
+      const double* solved = x.Row(j);
+      for (int c = 0; c < x.cols_; c++) target[c] -= tij * solved[c];
+    }
+    for (int c = 0; c < x.cols_; c++) target[c] /= diagonal;
+  }
+  return x;
+}
+
+// Подстановка для this^T X = b по столбцам this^T, то есть по
+// непрерывным упакованным строкам this
+S21Matrix S21TriangularMatrix::SolveTransposed(const S21Matrix& b) const {
+  if (b.rows_ != size_ || b.cols_ <= 0) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+
+  S21Matrix x(b);
+  x.PrepareWrite();
+  const bool lower = part_ == Part::kLower;
+  for (int step = 0; step < size_; step++) {
+    const int k = lower ? size_ - 1 - step : step;
+    const double* packed = PackedRow(k);
+    const double diagonal = packed[k - First(k)];
+    if (diagonal == 0.0) {
+      throw logic_error("Матрица вырожденная, решения не сущестсвует");
+    }
+
+    double* solved = x.Row(k);
+    for (int c = 0; c < x.cols_; c++) solved[c] /= diagonal;
+    for (int j = First(k); j < Last(k); j++) {
+      if (j == k) continue;
+      const double tkj = packed[j - First(k)];
+      double* target = x.Row(j);
+      for (int c = 0; c < x.cols_; c++) target[c] -= tkj * solved[c];
+    }
+  }
+  return x;
+}
+
+double S21TriangularMatrix::Determinant() const {
+  double determinant = 1.0;
+  for (int i = 0; i < size_; i++) determinant *= data_[Offset(i, i)];
+  return determinant;
+}
+
+// Симметричная матрица
+
+S21SymmetricMatrix::S21SymmetricMatrix(int size) : size_(size) {
+  if (size <= 0) {
+    throw invalid_argument("Размер матрицы не может быть меньше 0");
+  }
+  data_.assign(static_cast<size_t>(size) * (size + 1) / 2, 0.0);
+}
+
+double S21SymmetricMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+  return data_[Offset(i, j)];
+}
+
+double& S21SymmetricMatrix::operator()(int i, int j) {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+  return data_[Offset(i, j)];
+}
+
+S21SymmetricMatrix S21SymmetricMatrix::FromMatrix(const S21Matrix& matrix) {
+  if (matrix.rows_ != matrix.cols_) {
+    throw logic_error("Матрица не квадратная");
+  }
+
+  S21SymmetricMatrix result(matrix.rows_);
+  for (int i = 0; i < result.size_; i++) {
+    copy(matrix.Row(i), matrix.Row(i) + i + 1,
+         result.data_.data() + result.Offset(i, 0));
+  }
+  return result;
+}
+
+S21Matrix S21SymmetricMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; i++) {
+    const double* packed = data_.data() + Offset(i, 0);
+    double* row = result.Row(i);
+    for (int j = 0; j <= i; j++) {
+      row[j] = packed[j];
+      result.Row(j)[i] = packed[j];
+    }
+  }
+  return result;
+}
+
+// Строка i накапливает a(k, i) * a(k, 0..i) по всем строкам a;
+// потоки делят строки результата
+S21SymmetricMatrix S21SymmetricMatrix::Gram(const S21Matrix& a) {
+  if (a.rows_ == 0 || a.cols_ == 0) {
+    throw logic_error("Матрица пустая");
+  }
+
+  S21SymmetricMatrix result(a.cols_);
+  const size_t work = result.data_.size() * a.rows_;
+  S21ParallelFor(a.cols_, work, [&](int begin, int end) {
+    for (int k = 0; k < a.rows_; k++) {
+      const double* a_row = a.Row(k);
+      for (int i = begin; i < end; i++) {
+        const double aki = a_row[i];
+        double* packed = result.data_.data() + result.Offset(i, 0);
+        for (int j = 0; j <= i; j++) packed[j] += aki * a_row[j];
+      }
+    }
+  });
+  return result;
+}
+
+// Вариант Холецкого — Банашевича по строкам: L(i, j) выражается через
+// скалярное произведение уже готовых частей строк i и j
+optional<S21TriangularMatrix> S21SymmetricMatrix::TryCholesky() const {
+  S21TriangularMatrix l(size_, S21TriangularMatrix::Part::kLower);
+
+  for (int i = 0; i < size_; i++) {
+    const double* l_i = l.data_.data() + l.Offset(i, 0);
+    for (int j = 0; j <= i; j++) {
+      const double* l_j = l.data_.data() + l.Offset(j, 0);
+      double sum = data_[Offset(i, j)];
+      for (int k = 0; k < j; k++) sum -= l_i[k] * l_j[k];
+
+      if (i == j) {
+        if (!(sum > 0.0)) return nullopt;
+        l.data_[l.Offset(i, i)] = sqrt(sum);
+      } else {
+        l.data_[l.Offset(i, j)] = sum / l_j[j];
+      }
+    }
+  }
+  return l;
+}
+
+S21TriangularMatrix S21SymmetricMatrix::Cholesky() const {
+  optional<S21TriangularMatrix> l = TryCholesky();
+  if (!l) {
+    throw logic_error("Матрица не положительно определённая");
+  }
+  return std::move(*l);
+}
+
+// Каждый хранимый элемент (i, j) участвует дважды: в строке i с b(j, :)
+// и в строке j с b(i, :)
+S21Matrix S21SymmetricMatrix::Multiply(const S21Matrix& b) const {
+  if (b.rows_ != size_) {
+    throw invalid_argument(
+        "Столбцы в первой матрице не должны быть равными строкам во второй");
+  }
+
+  S21Matrix result(size_, b.cols_);
+  for (int i = 0; i < size_; i++) {
+    const double* packed = data_.data() + Offset(i, 0);
+    const double* b_i = b.Row(i);
+    double* target_i = result.Row(i);
+    for (int j = 0; j < i; j++) {
+      const double sij = packed[j];
+      const double* b_j = b.Row(j);
+      double* target_j = result.Row(j);
+      for (int c = 0; c < b.cols_; c++) {
+        target_i[c] += sij * b_j[c];
+        target_j[c] += sij * b_i[c];
+      }
+    }
+    for (int c = 0; c < b.cols_; c++) target_i[c] += packed[i] * b_i[c];
+  }
+  return result;
+}
+
+S21Matrix S21SymmetricMatrix::Solve(const S21Matrix& b) const {
+  if (b.rows_ != size_ || b.cols_ <= 0) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+
+  optional<S21TriangularMatrix> l = TryCholesky();
+  if (!l) {
+    return ToMatrix().Solve(b);
+  }
+  return l->SolveTransposed(l->Solve(b));
+}
+
+double S21SymmetricMatrix::Determinant() const {
+  optional<S21TriangularMatrix> l = TryCholesky();
+  if (!l) {
+    return ToMatrix().Determinant();
+  }
+
+  const double root = l->Determinant();
+  return root * root;
+}
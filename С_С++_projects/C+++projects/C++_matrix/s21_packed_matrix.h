@@ -0,0 +1,98 @@
+#ifndef S21_PACKED_MATRIX_H
+#define S21_PACKED_MATRIX_H
+
+#include <optional>
+
+#include "s21_matrix_oop.h"
+
+// Треугольная матрица n x n в упакованном виде: хранится n(n + 1) / 2
+// элементов по строкам. Для нижней строка i содержит столбцы [0, i], для
+// верхней — столбцы [i, n)
+class S21TriangularMatrix {
+ public:
+  enum class Part { kLower, kUpper };
+
+ private:
+  int size_;
+  Part part_;
+  vector<double> data_;
+
+  size_t Offset(int i, int j) const;
+  bool Stored(int i, int j) const {
+    return part_ == Part::kLower ? j <= i : j >= i;
+  }
+  // Начало упакованной строки i и её первый столбец
+  double* PackedRow(int i) { return data_.data() + Offset(i, First(i)); }
+  const double* PackedRow(int i) const {
+    return data_.data() + Offset(i, First(i));
+  }
+  int First(int i) const { return part_ == Part::kLower ? 0 : i; }
+  int Last(int i) const { return part_ == Part::kLower ? i + 1 : size_; }
+
+  friend class S21SymmetricMatrix;
+
+ public:
+  S21TriangularMatrix(int size, Part part);
+
+  int GetSize() const { return size_; }
+  Part GetPart() const { return part_; }
+
+  // Элементы вне треугольника равны нулю и не могут быть изменены:
+  // неконстантный operator() для них бросает out_of_range
+  double operator()(int i, int j) const;
+  double& operator()(int i, int j);
+  double GetElement(int i, int j) const { return (*this)(i, j); }
+
+  // Преобразования; из S21Matrix берётся только нужный треугольник
+  static S21TriangularMatrix FromMatrix(const S21Matrix& matrix, Part part);
+  S21Matrix ToMatrix() const;
+
+  // this * b, подстановка для this * X = b и this^T * X = b,
+  // произведение диагонали
+  S21Matrix Multiply(const S21Matrix& b) const;
+  S21Matrix Solve(const S21Matrix& b) const;
+  S21Matrix SolveTransposed(const S21Matrix& b) const;
+  double Determinant() const;
+};
+
+// Симметричная матрица n x n: хранится нижний треугольник по строкам,
+// элементы (i, j) и (j, i) — одна ячейка
+class S21SymmetricMatrix {
+ private:
+  int size_;
+  vector<double> data_;
+
+  size_t Offset(int i, int j) const {
+    if (j > i) swap(i, j);
+    return static_cast<size_t>(i) * (i + 1) / 2 + j;
+  }
+  // Множитель Холецкого или nullopt, если матрица не положительно
+  // определённая
+  optional<S21TriangularMatrix> TryCholesky() const;
+
+ public:
+  explicit S21SymmetricMatrix(int size);
+
+  int GetSize() const { return size_; }
+
+  double operator()(int i, int j) const;
+  double& operator()(int i, int j);
+
+  // Преобразования; из S21Matrix берётся нижний треугольник
+  static S21SymmetricMatrix FromMatrix(const S21Matrix& matrix);
+  S21Matrix ToMatrix() const;
+  // Матрица Грама столбцов a^T a сразу в упакованном виде
+  static S21SymmetricMatrix Gram(const S21Matrix& a);
+
+  // Разложение Холецкого this = L L^T; бросает logic_error, если матрица
+  // не положительно определена
+  S21TriangularMatrix Cholesky() const;
+
+  // this * b; решение и определитель через разложение Холецкого, а для
+  // незнакоопределённых матриц — через плотную S21Matrix
+  S21Matrix Multiply(const S21Matrix& b) const;
+  S21Matrix Solve(const S21Matrix& b) const;
+  double Determinant() const;
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "s21_sparse_matrix.h"
+
+S21SparseMatrix::S21SparseMatrix(int rows, int cols)
+    : rows_(rows), cols_(cols) {
+  if (rows <= 0 || cols <= 0) {
+    throw invalid_argument("Строки и столбцы не могут быть меньше 0");
+  }
+  offsets_.assign(rows + 1, 0);
+}
+
+double S21SparseMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+
+  const auto first = columns_.begin() + offsets_[i];
+  const auto last = columns_.begin() + offsets_[i + 1];
+  const auto found = lower_bound(first, last, j);
+  if (found == last || *found != j) return 0.0;
+  return values_[found - columns_.begin()];
+}
+
+S21SparseMatrix S21SparseMatrix::FromTriplets(int rows, int cols,
+                                              vector<Triplet> triplets) {
+  S21SparseMatrix result(rows, cols);
+  for (const Triplet& t : triplets) {
+    if (t.row < 0 || t.row >= rows || t.col < 0 || t.col >= cols) {
+      throw out_of_range("Аргументы не соответствуют матрице");
+    }
+  }
+
+  sort(triplets.begin(), triplets.end(),
+       [](const Triplet& x, const Triplet& y) {
+         return x.row != y.row ? x.row < y.row : x.col < y.col;
+       });
+
+  for (size_t k = 0; k < triplets.size();) {
+    const int row = triplets[k].row, col = triplets[k].col;
+    double value = 0.0;
+    for (; k < triplets.size() && triplets[k].row == row &&
+           triplets[k].col == col;
+         k++) {
+      value += triplets[k].value;
+    }
+    if (value == 0.0) continue;
+
+    result.columns_.push_back(col);
+    result.values_.push_back(value);
+    result.offsets_[row + 1]++;
+  }
+
+  for (int i = 0; i < rows; i++) {
+    result.offsets_[i + 1] += result.offsets_[i];
+  }
+  return result;
+}
+
+S21SparseMatrix S21SparseMatrix::FromMatrix(const S21Matrix& matrix) {
+  S21SparseMatrix result(matrix.GetRows(), matrix.GetCols());
+  for (int i = 0; i < result.rows_; i++) {
+    const double* row = matrix.Row(i);
+    for (int j = 0; j < result.cols_; j++) {
+      if (row[j] == 0.0) continue;
+      result.columns_.push_back(j);
+      result.values_.push_back(row[j]);
+    }
+    result.offsets_[i + 1] = static_cast<int>(result.values_.size());
+  }
+  return result;
+}
+
+S21Matrix S21SparseMatrix::ToMatrix() const {
+  S21Matrix result(rows_, cols_);
+  for (int i = 0; i < rows_; i++) {
+    double* row = result.Row(i);
+    for (int k = offsets_[i]; k < offsets_[i + 1]; k++) {
+      row[columns_[k]] = values_[k];
+    }
+  }
+  return result;
+}
+
+void S21SparseMatrix::MultiplyVector(span<const double> x,
+                                     span<double> y) const {
+  if (x.size() != static_cast<size_t>(cols_) ||
+      y.size() != static_cast<size_t>(rows_)) {
+    throw invalid_argument("Вектор не соответствует матрице");
+  }
+
+  S21ParallelFor(rows_, values_.size(), [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double sum = 0.0;
+      for (int k = offsets_[i]; k < offsets_[i + 1]; k++) {
+        sum += values_[k] * x[columns_[k]];
+      }
+      y[i] = sum;
+    }
+  });
+}
+
+// Строка i результата — комбинация строк b с ненулевыми элементами
+// строки i
+S21Matrix S21SparseMatrix::Multiply(const S21Matrix& b) const {
+  if (b.GetRows() != cols_) {
+    throw invalid_argument(
+        "Столбцы в первой матрице не должны быть равными строкам во второй");
+  }
+
+  const int width = b.GetCols();
+  S21Matrix result(rows_, width);
+  const size_t work = values_.size() * width;
+  S21ParallelFor(rows_, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* target = result.Row(i);
+      for (int k = offsets_[i]; k < offsets_[i + 1]; k++) {
+        const double value = values_[k];
+        const double* b_row = b.Row(columns_[k]);
+        for (int c = 0; c < width; c++) target[c] += value * b_row[c];
+      }
+    }
+  });
+  return result;
+}
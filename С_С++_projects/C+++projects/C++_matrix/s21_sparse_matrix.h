@@ -0,0 +1,50 @@
+#ifndef S21_SPARSE_MATRIX_H
+#define S21_SPARSE_MATRIX_H
+
+#include "s21_matrix_oop.h"
+
+// Разреженная матрица rows x cols в формате CSR: ненулевые элементы
+// строки i лежат в ячейках [offsets_[i], offsets_[i + 1]) по возрастанию
+// номеров столбцов
+class S21SparseMatrix {
+ public:
+  // Элемент для сборки матрицы
+  struct Triplet {
+    int row, col;
+    double value;
+  };
+
+ private:
+  int rows_, cols_;
+  vector<int> offsets_;
+  vector<int> columns_;
+  vector<double> values_;
+
+  friend class S21ConjugateGradient;
+
+ public:
+  // Нулевая матрица
+  S21SparseMatrix(int rows, int cols);
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  int GetNonZeros() const { return static_cast<int>(values_.size()); }
+
+  // Элемент ищется двоичным поиском по строке; неконстантного доступа
+  // нет, структура меняется только пересборкой
+  double operator()(int i, int j) const;
+  double GetElement(int i, int j) const { return (*this)(i, j); }
+
+  // Сборка: элементы с одинаковой позицией складываются, нули
+  // отбрасываются
+  static S21SparseMatrix FromTriplets(int rows, int cols,
+                                      vector<Triplet> triplets);
+  static S21SparseMatrix FromMatrix(const S21Matrix& matrix);
+  S21Matrix ToMatrix() const;
+
+  // y = this * x; строки делятся между потоками
+  void MultiplyVector(span<const double> x, span<double> y) const;
+  S21Matrix Multiply(const S21Matrix& b) const;
+};
+
+#endif
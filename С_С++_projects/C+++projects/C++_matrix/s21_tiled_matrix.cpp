@@ -0,0 +1,370 @@
+#include "s21_tiled_matrix.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+
+namespace {
+
+// Участок файла тайлов, отображённый в память на время жизни объекта
+class MappedTile {
+ private:
+  double* data_ = nullptr;
+  size_t bytes_ = 0;
+
+ public:
+  MappedTile() = default;
+
+  MappedTile(int fd, off_t offset, size_t bytes, bool writable)
+      : bytes_(bytes) {
+    // Обращение к странице за концом файла — SIGBUS, поэтому укороченный
+    // файл отвергается заранее
+    struct stat status;
+    if (fstat(fd, &status) != 0 ||
+        status.st_size < offset + static_cast<off_t>(bytes)) {
+      throw runtime_error("Файл тайлов короче ожидаемого");
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    // Страницы читаются сразу, пока тайл подгружается фоновым потоком
+    flags |= MAP_POPULATE;
+#endif
+    void* data = mmap(nullptr, bytes, PROT_READ | (writable ? PROT_WRITE : 0),
+                      flags, fd, offset);
+    if (data == MAP_FAILED) {
+      throw runtime_error("Не удалось отобразить тайл");
+    }
+    data_ = static_cast<double*>(data);
+  }
+
+  MappedTile(MappedTile&& other) noexcept
+      : data_(other.data_), bytes_(other.bytes_) {
+    other.data_ = nullptr;
+  }
+
+  MappedTile& operator=(MappedTile&& other) noexcept {
+    swap(data_, other.data_);
+    swap(bytes_, other.bytes_);
+    return *this;
+  }
+
+  ~MappedTile() {
+    if (data_) munmap(data_, bytes_);
+  }
+
+  double* Data() const { return data_; }
+};
+
+// c += a * b для тайлов tile x tile, порядок i-k-j
+void TileMultiplyAdd(const double* a, const double* b, double* c, int tile) {
+  const size_t work = static_cast<size_t>(tile) * tile * tile;
+  S21ParallelFor(tile, work, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* c_row = c + static_cast<size_t>(i) * tile;
+      const double* a_row = a + static_cast<size_t>(i) * tile;
+      for (int k = 0; k < tile; k++) {
+        const double aik = a_row[k];
+        const double* b_row = b + static_cast<size_t>(k) * tile;
+        for (int j = 0; j < tile; j++) c_row[j] += aik * b_row[j];
+      }
+    }
+  });
+}
+
+// pread и pwrite могут передать меньше запрошенного
+void ReadExact(int fd, void* data, size_t bytes, off_t offset) {
+  char* target = static_cast<char*>(data);
+  while (bytes > 0) {
+    const ssize_t done = pread(fd, target, bytes, offset);
+    if (done <= 0) {
+      throw runtime_error("Не удалось прочитать файл тайлов");
+    }
+    target += done;
+    bytes -= static_cast<size_t>(done);
+    offset += done;
+  }
+}
+
+void WriteExact(int fd, const void* data, size_t bytes, off_t offset) {
+  const char* source = static_cast<const char*>(data);
+  while (bytes > 0) {
+    const ssize_t done = pwrite(fd, source, bytes, offset);
+    if (done <= 0) {
+      throw runtime_error("Не удалось записать файл тайлов");
+    }
+    source += done;
+    bytes -= static_cast<size_t>(done);
+    offset += done;
+  }
+}
+
+}  // namespace
+
+S21TiledMatrix::S21TiledMatrix(const string& directory, int rows, int cols,
+                               int tile)
+    : directory_(directory), rows_(rows), cols_(cols), tile_(tile), fd_(-1) {
+  if (rows <= 0 || cols <= 0 || tile <= 0) {
+    throw invalid_argument("Строки, столбцы и тайл не могут быть меньше 0");
+  }
+
+  // Участки тайлов выравниваются по странице, чтобы отображать их по
+  // отдельности
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  slot_bytes_ = (TileBytes() + page - 1) / page * page;
+
+  filesystem::create_directories(directory_);
+
+  const string path = directory_ + "/tiles.bin";
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    throw runtime_error("Не удалось создать файл тайлов " + path);
+  }
+  const off_t size = TileOffset(GetTileRows(), 0);
+  if (ftruncate(fd_, size) != 0) {
+    close(fd_);
+    throw runtime_error("Не удалось выделить место под тайлы " + path);
+  }
+}
+
+S21TiledMatrix::~S21TiledMatrix() {
+  if (fd_ >= 0) close(fd_);
+}
+
+S21TiledMatrix::S21TiledMatrix(S21TiledMatrix&& other) noexcept
+    : directory_(std::move(other.directory_)),
+      rows_(other.rows_),
+      cols_(other.cols_),
+      tile_(other.tile_),
+      fd_(other.fd_),
+      slot_bytes_(other.slot_bytes_) {
+  other.fd_ = -1;
+}
+
+size_t S21TiledMatrix::TileBytes() const {
+  return static_cast<size_t>(tile_) * tile_ * sizeof(double);
+}
+
+off_t S21TiledMatrix::TileOffset(int ti, int tj) const {
+  return static_cast<off_t>(
+      (static_cast<size_t>(ti) * GetTileCols() + tj) * slot_bytes_);
+}
+
+void S21TiledMatrix::CheckTile(int ti, int tj) const {
+  if (ti < 0 || ti >= GetTileRows() || tj < 0 || tj >= GetTileCols()) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+}
+
+double S21TiledMatrix::GetElement(int i, int j) const {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+
+  const off_t offset =
+      TileOffset(i / tile_, j / tile_) +
+      static_cast<off_t>((static_cast<size_t>(i % tile_) * tile_ + j % tile_) *
+                         sizeof(double));
+  double value = 0.0;
+  ReadExact(fd_, &value, sizeof(value), offset);
+  return value;
+}
+
+void S21TiledMatrix::SetElement(int i, int j, double value) {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_) {
+    throw out_of_range("Аргументы не соответствуют матрице");
+  }
+
+  const off_t offset =
+      TileOffset(i / tile_, j / tile_) +
+      static_cast<off_t>((static_cast<size_t>(i % tile_) * tile_ + j % tile_) *
+                         sizeof(double));
+  WriteExact(fd_, &value, sizeof(value), offset);
+}
+
+void S21TiledMatrix::ReadTile(int ti, int tj, double* data) const {
+  CheckTile(ti, tj);
+  ReadExact(fd_, data, TileBytes(), TileOffset(ti, tj));
+}
+
+// Элементы за границей матрицы записываются нулями: умножение тайлов
+// проходит по ним целиком
+void S21TiledMatrix::WriteTile(int ti, int tj, const double* data) {
+  CheckTile(ti, tj);
+
+  const int row_end = min(tile_, rows_ - ti * tile_);
+  const int col_end = min(tile_, cols_ - tj * tile_);
+  if (row_end == tile_ && col_end == tile_) {
+    WriteExact(fd_, data, TileBytes(), TileOffset(ti, tj));
+    return;
+  }
+
+  vector<double> padded(static_cast<size_t>(tile_) * tile_, 0.0);
+  for (int i = 0; i < row_end; i++) {
+    const double* row = data + static_cast<size_t>(i) * tile_;
+    copy(row, row + col_end, padded.data() + static_cast<size_t>(i) * tile_);
+  }
+  WriteExact(fd_, padded.data(), TileBytes(), TileOffset(ti, tj));
+}
+
+S21TiledMatrix S21TiledMatrix::FromMatrix(const S21Matrix& matrix,
+                                          const string& directory, int tile) {
+  S21TiledMatrix result(directory, matrix.GetRows(), matrix.GetCols(), tile);
+  vector<double> data(static_cast<size_t>(tile) * tile);
+
+  for (int ti = 0; ti < result.GetTileRows(); ti++) {
+    for (int tj = 0; tj < result.GetTileCols(); tj++) {
+      const int row_end = min(tile, matrix.GetRows() - ti * tile);
+      const int col_end = min(tile, matrix.GetCols() - tj * tile);
+      for (int i = 0; i < row_end; i++) {
+        const double* row = matrix.Row(ti * tile + i) + tj * tile;
+        copy(row, row + col_end, data.data() + static_cast<size_t>(i) * tile);
+      }
+      result.WriteTile(ti, tj, data.data());
+    }
+  }
+  return result;
+}
+
+S21Matrix S21TiledMatrix::ToMatrix() const {
+  S21Matrix result(rows_, cols_);
+  vector<double> data(static_cast<size_t>(tile_) * tile_);
+
+  for (int ti = 0; ti < GetTileRows(); ti++) {
+    for (int tj = 0; tj < GetTileCols(); tj++) {
+      ReadTile(ti, tj, data.data());
+
+      const int row_end = min(tile_, rows_ - ti * tile_);
+      const int col_end = min(tile_, cols_ - tj * tile_);
+      for (int i = 0; i < row_end; i++) {
+        const double* row = data.data() + static_cast<size_t>(i) * tile_;
+        copy(row, row + col_end, result.Row(ti * tile_ + i) + tj * tile_);
+      }
+    }
+  }
+  return result;
+}
+
+void S21TiledMatrix::Multiply(const S21TiledMatrix& a, const S21TiledMatrix& b,
+                              S21TiledMatrix& c, size_t memory) {
+  if (a.cols_ != b.rows_) {
+    throw invalid_argument(
+        "Столбцы в первой матрице не должны быть равными строкам во второй");
+  }
+  if (c.rows_ != a.rows_ || c.cols_ != b.cols_ || a.tile_ != b.tile_ ||
+      a.tile_ != c.tile_) {
+    throw invalid_argument("Матрицы разного размера");
+  }
+  // Тайл результата обнуляется до того, как прочитаны все тайлы операндов
+  if (&c == &a || &c == &b ||
+      filesystem::equivalent(c.directory_, a.directory_) ||
+      filesystem::equivalent(c.directory_, b.directory_)) {
+    throw invalid_argument("Результат не может совпадать с операндом");
+  }
+
+  // В памяти одновременно панель A из height x width тайлов, height
+  // тайлов C и два тайла B (текущий и подгружаемый). Если помещаются все
+  // столбцы A, каждый тайл A читается один раз, а B — tiles_i / height
+  // раз; иначе панель идёт по части k и C накапливается между частями
+  const int tiles_i = a.GetTileRows(), tiles_j = b.GetTileCols();
+  const int tiles_k = a.GetTileCols();
+  const size_t budget = max<size_t>(4, memory / a.TileBytes());
+  int height = 1, width = tiles_k;
+  if (budget >= static_cast<size_t>(tiles_k) + 3) {
+    const size_t rows = (budget - 2) / (static_cast<size_t>(tiles_k) + 1);
+    height = static_cast<int>(min<size_t>(tiles_i, rows));
+  } else {
+    width = static_cast<int>(budget - 3);
+  }
+
+  // Порядок чтения тайлов операндов: панель A, затем столбцы B под неё
+  struct Load {
+    const S21TiledMatrix* matrix;
+    int ti, tj;
+  };
+  vector<Load> loads;
+  for (int i0 = 0; i0 < tiles_i; i0 += height) {
+    const int i1 = min(tiles_i, i0 + height);
+    for (int k0 = 0; k0 < tiles_k; k0 += width) {
+      const int k1 = min(tiles_k, k0 + width);
+      for (int i = i0; i < i1; i++) {
+        for (int k = k0; k < k1; k++) loads.push_back({&a, i, k});
+      }
+      for (int j = 0; j < tiles_j; j++) {
+        for (int k = k0; k < k1; k++) loads.push_back({&b, k, j});
+      }
+    }
+  }
+
+  // Один поток подгрузки идёт на тайл впереди: кладёт следующий тайл в
+  // слот и ждёт, пока умножение заберёт его. При исключении в этом
+  // потоке деструктор jthread останавливает и присоединяет загрузчик
+  mutex slot_mutex;
+  condition_variable_any slot_changed;
+  optional<MappedTile> slot;
+  exception_ptr load_error;
+
+  jthread loader([&](stop_token stop) {
+    for (const Load& load : loads) {
+      MappedTile tile;
+      try {
+        tile = MappedTile(load.matrix->fd_,
+                          load.matrix->TileOffset(load.ti, load.tj),
+                          load.matrix->TileBytes(), false);
+      } catch (...) {
+        lock_guard<mutex> lock(slot_mutex);
+        load_error = current_exception();
+        slot_changed.notify_all();
+        return;
+      }
+
+      unique_lock<mutex> lock(slot_mutex);
+      if (!slot_changed.wait(lock, stop, [&] { return !slot; })) return;
+      slot = std::move(tile);
+      slot_changed.notify_all();
+    }
+  });
+
+  auto take = [&] {
+    unique_lock<mutex> lock(slot_mutex);
+    slot_changed.wait(lock, [&] { return slot || load_error; });
+    if (!slot) rethrow_exception(load_error);
+    MappedTile tile = std::move(*slot);
+    slot.reset();
+    slot_changed.notify_all();
+    return tile;
+  };
+
+  vector<MappedTile> panel;
+  vector<MappedTile> c_tiles;
+  for (int i0 = 0; i0 < tiles_i; i0 += height) {
+    const int i1 = min(tiles_i, i0 + height);
+    for (int k0 = 0; k0 < tiles_k; k0 += width) {
+      const int k1 = min(tiles_k, k0 + width);
+      panel.clear();
+      for (int t = 0; t < (i1 - i0) * (k1 - k0); t++) panel.push_back(take());
+
+      for (int j = 0; j < tiles_j; j++) {
+        c_tiles.clear();
+        for (int i = i0; i < i1; i++) {
+          c_tiles.emplace_back(c.fd_, c.TileOffset(i, j), c.TileBytes(), true);
+          if (k0 == 0) memset(c_tiles.back().Data(), 0, c.TileBytes());
+        }
+
+        for (int k = k0; k < k1; k++) {
+          const MappedTile b_tile = take();
+          for (int i = i0; i < i1; i++) {
+            TileMultiplyAdd(panel[(i - i0) * (k1 - k0) + (k - k0)].Data(),
+                            b_tile.Data(), c_tiles[i - i0].Data(), c.tile_);
+          }
+        }
+      }
+    }
+  }
+}
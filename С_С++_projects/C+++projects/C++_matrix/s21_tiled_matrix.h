@@ -0,0 +1,65 @@
+#ifndef S21_TILED_MATRIX_H
+#define S21_TILED_MATRIX_H
+
+#include <string>
+
+#include "s21_matrix_oop.h"
+
+// Матрица на диске: элементы хранятся квадратными тайлами tile x tile в
+// файле tiles.bin внутри каталога. Каждый тайл занимает выровненный по
+// странице участок файла и отображается в память только на время работы
+// с ним. Файл открыт всё время жизни объекта и остаётся на диске после
+// его уничтожения, повторное создание с теми же размерами открывает его
+// заново
+class S21TiledMatrix {
+ private:
+  string directory_;
+  int rows_, cols_, tile_;
+  int fd_;
+  size_t slot_bytes_;
+
+  size_t TileBytes() const;
+  off_t TileOffset(int ti, int tj) const;
+  void CheckTile(int ti, int tj) const;
+
+ public:
+  // Создаёт каталог и файл тайлов (новые тайлы заполнены нулями)
+  S21TiledMatrix(const string& directory, int rows, int cols, int tile);
+  ~S21TiledMatrix();
+
+  S21TiledMatrix(const S21TiledMatrix& other) = delete;
+  S21TiledMatrix& operator=(const S21TiledMatrix& other) = delete;
+  S21TiledMatrix(S21TiledMatrix&& other) noexcept;
+
+  // Аксессоры
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  int GetTileSize() const { return tile_; }
+  int GetTileRows() const { return (rows_ + tile_ - 1) / tile_; }
+  int GetTileCols() const { return (cols_ + tile_ - 1) / tile_; }
+
+  double GetElement(int i, int j) const;
+  void SetElement(int i, int j, double value);
+
+  // Тайл (ti, tj) целиком: tile * tile элементов по строкам, элементы за
+  // границей матрицы — нули. Позволяет собрать матрицу больше памяти по
+  // одному тайлу
+  void ReadTile(int ti, int tj, double* data) const;
+  void WriteTile(int ti, int tj, const double* data);
+
+  // Преобразования
+  static S21TiledMatrix FromMatrix(const S21Matrix& matrix,
+                                   const string& directory, int tile);
+  S21Matrix ToMatrix() const;
+
+  // c = a * b вне памяти. Панель тайлов a остаётся отображённой в пределах
+  // memory байт, тайлы b проходят мимо неё по одному и подгружаются
+  // фоновым потоком во время умножения предыдущего. Бюджет меньше четырёх
+  // тайлов увеличивается до четырёх. c не может быть ни a, ни b (в том
+  // числе через тот же каталог)
+  static constexpr size_t kDefaultMemory = size_t(1) << 30;
+  static void Multiply(const S21TiledMatrix& a, const S21TiledMatrix& b,
+                       S21TiledMatrix& c, size_t memory = kDefaultMemory);
+};
+
+#endif
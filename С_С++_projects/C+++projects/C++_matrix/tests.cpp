@@ -1,6 +1,18 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <filesystem>
+#include <numeric>
+
+#include "s21_band_matrix.h"
+#include "s21_conjugate_gradient.h"
+#include "s21_half_matrix.h"
+#include "s21_inverse_updater.h"
 #include "s21_matrix_oop.h"
+#include "s21_packed_matrix.h"
+#include "s21_sparse_matrix.h"
+#include "s21_tiled_matrix.h"
+#include "s21_vector_math.h"
 
 TEST(MatrixTest, DefaultConstructor) {
   S21Matrix matrix;
@@ -494,6 +506,1613 @@ TEST(MatrixTest, OperatorParentheses) {
   EXPECT_THROW(matrix(0, -1), std::out_of_range);
 }
 
+TEST(MatrixTest, ScaleAndAddScaled) {
+  S21Matrix w(2, 2);
+  w(0, 0) = 1.0;
+  w(0, 1) = 2.0;
+  w(1, 0) = 3.0;
+  w(1, 1) = 4.0;
+
+  S21Matrix g(2, 2);
+  g(0, 0) = 10.0;
+  g(1, 1) = -10.0;
+
+  w.AddScaled(-0.1, g);
+  EXPECT_DOUBLE_EQ(w(0, 0), 0.0);
+  EXPECT_DOUBLE_EQ(w(0, 1), 2.0);
+  EXPECT_DOUBLE_EQ(w(1, 1), 5.0);
+
+  w.Scale(2.0).AddScaled(1.0, g);
+  EXPECT_DOUBLE_EQ(w(0, 0), 10.0);
+  EXPECT_DOUBLE_EQ(w(0, 1), 4.0);
+  EXPECT_DOUBLE_EQ(w(1, 0), 6.0);
+  EXPECT_DOUBLE_EQ(w(1, 1), 0.0);
+
+  S21Matrix m(3, 2);
+  EXPECT_THROW(w.AddScaled(1.0, m), std::invalid_argument);
+}
+
+TEST(MatrixTest, Gemm) {
+  S21Matrix a(2, 3);
+  S21Matrix b(3, 2);
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 3; j++) {
+      a(i, j) = i + j + 1;
+      b(j, i) = j - i;
+    }
+  }
+
+  S21Matrix c(2, 2);
+  c(0, 0) = 1.0;
+  c(1, 1) = 1.0;
+  S21Matrix expected = 2.0 * (a * b) + 3.0 * c;
+
+  c.Gemm(2.0, a, b, 3.0);
+  EXPECT_TRUE(c == expected);
+
+  S21Matrix d = c;
+  S21Matrix expected_alias = d * d;
+  d.Gemm(1.0, d, d, 0.0);
+  EXPECT_TRUE(d == expected_alias);
+
+  S21Matrix wrong(3, 3);
+  EXPECT_THROW(wrong.Gemm(1.0, a, b, 0.0), std::invalid_argument);
+  EXPECT_THROW(c.Gemm(1.0, a, a, 0.0), std::invalid_argument);
+}
+
+TEST(MatrixTest, CopyOnWrite) {
+  S21Matrix matrix(5, 5);
+  matrix(0, 0) = 1.0;
+  matrix(1, 1) = 2.0;
+  for (int i = 2; i < 5; i++) matrix(i, i) = 1.0;
+  matrix.SetCopyOnWrite(true);
+  EXPECT_TRUE(matrix.IsCopyOnWrite());
+  EXPECT_FALSE(matrix.IsShared());
+
+  S21Matrix copy(matrix);
+  S21Matrix assigned;
+  assigned = copy;
+  EXPECT_TRUE(matrix.IsShared());
+  EXPECT_TRUE(assigned.IsCopyOnWrite());
+  EXPECT_DOUBLE_EQ(copy.GetElement(1, 1), 2.0);
+  EXPECT_TRUE(matrix.IsShared());
+
+  copy.SetElement(0, 0, 5.0);
+  EXPECT_DOUBLE_EQ(copy(0, 0), 5.0);
+  EXPECT_DOUBLE_EQ(matrix.GetElement(0, 0), 1.0);
+  EXPECT_DOUBLE_EQ(assigned.GetElement(0, 0), 1.0);
+
+  assigned.SumMatrix(matrix);
+  EXPECT_DOUBLE_EQ(assigned.GetElement(1, 1), 4.0);
+  EXPECT_DOUBLE_EQ(matrix.GetElement(1, 1), 2.0);
+  EXPECT_FALSE(matrix.IsShared());
+
+  S21Matrix grown(matrix);
+  grown.SetRows(6);
+  grown *= matrix.Transpose();
+  EXPECT_EQ(matrix.GetRows(), 5);
+  EXPECT_TRUE(grown.IsCopyOnWrite());
+
+  S21Matrix plain(matrix);
+  plain.SetCopyOnWrite(false);
+  EXPECT_FALSE(plain.IsCopyOnWrite());
+  EXPECT_FALSE(matrix.IsShared());
+  EXPECT_DOUBLE_EQ(matrix.Determinant(), 2.0);
+}
+
+TEST(MatrixTest, ReserveAndAppendRow) {
+  S21Matrix matrix;
+  matrix.Reserve(4, 3);
+  EXPECT_EQ(matrix.GetRows(), 0);
+  EXPECT_EQ(matrix.GetRowsCapacity(), 4);
+  EXPECT_EQ(matrix.GetColsCapacity(), 3);
+
+  const double row[] = {1.0, 2.0, 3.0};
+  for (int i = 0; i < 100; i++) {
+    matrix.AppendRow(row);
+    matrix(i, 0) = i;
+  }
+  EXPECT_EQ(matrix.GetRows(), 100);
+  EXPECT_EQ(matrix.GetCols(), 3);
+  EXPECT_GE(matrix.GetRowsCapacity(), 100);
+  EXPECT_DOUBLE_EQ(matrix(57, 0), 57.0);
+  EXPECT_DOUBLE_EQ(matrix(99, 2), 3.0);
+
+  const double wrong[] = {1.0, 2.0};
+  EXPECT_THROW(matrix.AppendRow(wrong), std::invalid_argument);
+  EXPECT_THROW(matrix.Reserve(-1, 2), std::invalid_argument);
+}
+
+TEST(MatrixTest, CapacityGrowth) {
+  S21Matrix matrix(2, 2);
+  matrix(1, 1) = 7.0;
+
+  matrix.SetCols(3);
+  const int cols_capacity = matrix.GetColsCapacity();
+  EXPECT_GE(cols_capacity, 4);
+  matrix.SetCols(cols_capacity);
+  EXPECT_EQ(matrix.GetColsCapacity(), cols_capacity);
+  EXPECT_DOUBLE_EQ(matrix(1, 1), 7.0);
+
+  matrix(0, 1) = 5.0;
+  matrix.SetCols(1);
+  matrix.SetRows(1);
+  matrix.SetCols(2);
+  matrix.SetRows(2);
+  EXPECT_DOUBLE_EQ(matrix(0, 1), 0.0);
+  EXPECT_DOUBLE_EQ(matrix(1, 1), 0.0);
+
+  matrix.SetCopyOnWrite(true);
+  S21Matrix copy(matrix);
+  matrix.SetRows(1);
+  copy.SetRows(2);
+  matrix.SetRows(2);
+  matrix(1, 0) = 1.0;
+  EXPECT_DOUBLE_EQ(copy(1, 0), 0.0);
+}
+
+TEST(MatrixTest, Reductions) {
+  S21Matrix matrix(2, 3);
+  matrix(0, 0) = 1.0;
+  matrix(0, 1) = -2.0;
+  matrix(0, 2) = 3.0;
+  matrix(1, 0) = -4.0;
+  matrix(1, 1) = 5.0;
+  matrix(1, 2) = -6.0;
+
+  EXPECT_DOUBLE_EQ(matrix.Sum(), -3.0);
+  EXPECT_DOUBLE_EQ(matrix.Sum(true), -3.0);
+  EXPECT_DOUBLE_EQ(matrix.FrobeniusNorm(), sqrt(91.0));
+  EXPECT_DOUBLE_EQ(matrix.Norm1(), 9.0);
+  EXPECT_DOUBLE_EQ(matrix.NormInf(), 15.0);
+  EXPECT_DOUBLE_EQ(matrix.Min(), -6.0);
+  EXPECT_DOUBLE_EQ(matrix.Max(), 5.0);
+  EXPECT_EQ(matrix.ArgMin(), std::make_pair(1, 2));
+  EXPECT_EQ(matrix.ArgMax(), std::make_pair(1, 1));
+
+  S21Matrix row_sums = matrix.RowSums();
+  EXPECT_EQ(row_sums.GetRows(), 2);
+  EXPECT_EQ(row_sums.GetCols(), 1);
+  EXPECT_DOUBLE_EQ(row_sums(0, 0), 2.0);
+  EXPECT_DOUBLE_EQ(row_sums(1, 0), -5.0);
+
+  S21Matrix col_means = matrix.ColMeans();
+  EXPECT_EQ(col_means.GetRows(), 1);
+  EXPECT_EQ(col_means.GetCols(), 3);
+  EXPECT_DOUBLE_EQ(col_means(0, 0), -1.5);
+  EXPECT_DOUBLE_EQ(col_means(0, 1), 1.5);
+  EXPECT_DOUBLE_EQ(matrix.ColSums(true)(0, 2), -3.0);
+
+  S21Matrix empty;
+  EXPECT_DOUBLE_EQ(empty.Sum(), 0.0);
+  EXPECT_DOUBLE_EQ(empty.NormInf(), 0.0);
+  EXPECT_THROW(empty.Max(), std::logic_error);
+
+  // Достаточно велика для параллельной редукции, максимум в последней строке
+  S21Matrix large(512, 512);
+  large.Apply([](double) { return -0.5; });
+  large(511, 0) = -300.0;
+  EXPECT_DOUBLE_EQ(large.NormInf(), 300.0 + 511 * 0.5);
+  EXPECT_DOUBLE_EQ(large.Norm1(), 300.0 + 511 * 0.5);
+
+  // Суммы строк складываются в одном порядке при любом числе потоков
+  S21Matrix noisy(600, 300);
+  for (int i = 0; i < 600; i++) {
+    for (int j = 0; j < 300; j++) noisy(i, j) = std::sin(i * 0.37 + j * 1.1);
+  }
+  EXPECT_EQ(noisy.Sum(), noisy.RowSums().Sum());
+}
+
+TEST(MatrixTest, CompensatedReductions) {
+  S21Matrix matrix(2, 4);
+  for (int i = 0; i < 2; i++) {
+    matrix(i, 0) = 1e100;
+    matrix(i, 1) = 1.0;
+    matrix(i, 2) = -1e100;
+    matrix(i, 3) = 1.0;
+  }
+
+  EXPECT_DOUBLE_EQ(matrix.Sum(true), 4.0);
+  EXPECT_DOUBLE_EQ(matrix.RowSums(true)(1, 0), 2.0);
+
+  S21Matrix column(3, 1);
+  column(0, 0) = 1e100;
+  column(1, 0) = 1.0;
+  column(2, 0) = -1e100;
+  EXPECT_DOUBLE_EQ(column.ColSums(true)(0, 0), 1.0);
+
+  S21Matrix large(300, 300);
+  for (int i = 0; i < 300; i++) {
+    for (int j = 0; j < 300; j++) large(i, j) = (i * 300 + j) % 7 - 3.0;
+  }
+  EXPECT_NEAR(large.Sum(), large.Sum(true), 1e-9);
+  EXPECT_NEAR(large.ColSums().Sum(), large.RowSums().Sum(), 1e-9);
+}
+
+TEST(MatrixTest, Solve) {
+  S21Matrix a(3, 3);
+  a(0, 0) = 2.0;
+  a(0, 1) = 5.0;
+  a(0, 2) = 7.0;
+  a(1, 0) = 6.0;
+  a(1, 1) = 3.0;
+  a(1, 2) = 4.0;
+  a(2, 0) = 5.0;
+  a(2, 1) = -2.0;
+  a(2, 2) = -3.0;
+
+  S21Matrix b(3, 2);
+  b(0, 0) = 1.0;
+  b(1, 1) = 1.0;
+  b(2, 0) = 2.0;
+
+  S21Matrix expected = a.InverseMatrix() * b;
+  EXPECT_TRUE(a.Solve(b) == expected);
+  EXPECT_TRUE(a.Solve(b, S21Matrix::SolveMode::kMixed) == expected);
+
+  S21Matrix singular(2, 2);
+  singular(0, 0) = singular(0, 1) = singular(1, 0) = singular(1, 1) = 1.0;
+  S21Matrix rhs(2, 1);
+  EXPECT_THROW(singular.Solve(rhs), std::logic_error);
+  EXPECT_THROW(singular.Solve(rhs, S21Matrix::SolveMode::kMixed),
+               std::logic_error);
+  EXPECT_THROW(a.Solve(rhs), std::invalid_argument);
+}
+
+TEST(MatrixTest, SolveMixedPrecision) {
+  const int n = 60;
+  S21Matrix a(n, n);
+  S21Matrix x(n, 1);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) a(i, j) = 1.0 / (1.0 + i + 2 * j);
+    a(i, i) += n;
+    x(i, 0) = std::sin(i + 1.0);
+  }
+  S21Matrix b = a * x;
+
+  S21Matrix mixed = a.Solve(b, S21Matrix::SolveMode::kMixed);
+  for (int i = 0; i < n; i++) {
+    EXPECT_NEAR(mixed(i, 0), x(i, 0), 1e-13);
+  }
+
+  // Матрица Гильберта: float-разложение не сходится, работает запасной путь
+  S21Matrix hilbert(7, 7);
+  S21Matrix ones(7, 1);
+  for (int i = 0; i < 7; i++) {
+    for (int j = 0; j < 7; j++) hilbert(i, j) = 1.0 / (i + j + 1);
+    ones(i, 0) = 1.0;
+  }
+  S21Matrix rhs = hilbert * ones;
+  S21Matrix fallback = hilbert.Solve(rhs, S21Matrix::SolveMode::kMixed);
+  EXPECT_TRUE(fallback == hilbert.Solve(rhs));
+}
+
+TEST(TiledMatrixTest, ConvertAndAccess) {
+  const std::string dir =
+      std::filesystem::temp_directory_path() / "s21_tiled_convert";
+  std::filesystem::remove_all(dir);
+
+  S21Matrix matrix(5, 3);
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 3; j++) matrix(i, j) = i * 3 + j;
+  }
+
+  S21TiledMatrix tiled = S21TiledMatrix::FromMatrix(matrix, dir, 2);
+  EXPECT_EQ(tiled.GetTileRows(), 3);
+  EXPECT_EQ(tiled.GetTileCols(), 2);
+  EXPECT_DOUBLE_EQ(tiled.GetElement(4, 2), 14.0);
+
+  tiled.SetElement(3, 1, -1.0);
+  matrix(3, 1) = -1.0;
+  EXPECT_TRUE(tiled.ToMatrix() == matrix);
+
+  S21TiledMatrix reopened(dir, 5, 3, 2);
+  EXPECT_DOUBLE_EQ(reopened.GetElement(3, 1), -1.0);
+  EXPECT_THROW(reopened.GetElement(5, 0), std::out_of_range);
+  EXPECT_THROW(S21TiledMatrix(dir, 0, 3, 2), std::invalid_argument);
+
+  // Сборка по тайлам без матрицы в памяти; за границей пишутся нули
+  S21TiledMatrix built(dir + "_built", 5, 3, 2);
+  for (int ti = 0; ti < 3; ti++) {
+    for (int tj = 0; tj < 2; tj++) {
+      double data[4];
+      for (int k = 0; k < 4; k++) data[k] = (ti * 2 + tj) * 10 + k;
+      built.WriteTile(ti, tj, data);
+    }
+  }
+  EXPECT_DOUBLE_EQ(built.GetElement(3, 2), 32.0);
+  EXPECT_DOUBLE_EQ(built.GetElement(4, 1), 41.0);
+  double corner[4];
+  built.ReadTile(2, 1, corner);
+  EXPECT_DOUBLE_EQ(corner[0], 50.0);
+  EXPECT_DOUBLE_EQ(corner[1], 0.0);
+  EXPECT_DOUBLE_EQ(corner[2], 0.0);
+  EXPECT_THROW(built.ReadTile(3, 0, corner), std::out_of_range);
+  std::filesystem::remove_all(dir + "_built");
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST(TiledMatrixTest, Multiply) {
+  const std::filesystem::path dir =
+      std::filesystem::temp_directory_path() / "s21_tiled_multiply";
+  std::filesystem::remove_all(dir);
+
+  S21Matrix a(7, 5);
+  S21Matrix b(5, 4);
+  for (int i = 0; i < 7; i++) {
+    for (int j = 0; j < 5; j++) a(i, j) = std::sin(i + 2.0 * j);
+  }
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 4; j++) b(i, j) = std::cos(3.0 * i - j);
+  }
+
+  S21TiledMatrix tiled_a = S21TiledMatrix::FromMatrix(a, dir / "a", 3);
+  S21TiledMatrix tiled_b = S21TiledMatrix::FromMatrix(b, dir / "b", 3);
+  S21TiledMatrix tiled_c(dir / "c", 7, 4, 3);
+  S21TiledMatrix::Multiply(tiled_a, tiled_b, tiled_c);
+  EXPECT_TRUE(tiled_c.ToMatrix() == a * b);
+
+  // Бюджет в 0 и 4 тайла — панель из одного тайла a, c накапливается по
+  // частям k; 5 тайлов — строка тайлов a; 8 — две строки
+  const size_t tile_bytes = 3 * 3 * sizeof(double);
+  for (size_t tiles : {0, 4, 5, 8}) {
+    S21TiledMatrix tiled_d(dir / "d", 7, 4, 3);
+    S21TiledMatrix::Multiply(tiled_a, tiled_b, tiled_d, tiles * tile_bytes);
+    EXPECT_TRUE(tiled_d.ToMatrix() == a * b);
+  }
+
+  S21TiledMatrix wrong(dir / "wrong", 7, 5, 3);
+  EXPECT_THROW(S21TiledMatrix::Multiply(tiled_a, tiled_b, wrong),
+               std::invalid_argument);
+  EXPECT_THROW(S21TiledMatrix::Multiply(tiled_a, tiled_a, tiled_c),
+               std::invalid_argument);
+
+  S21Matrix square(5, 5);
+  for (int i = 0; i < 5; i++) square(i, i) = i + 1.0;
+  S21TiledMatrix tiled_sq = S21TiledMatrix::FromMatrix(square, dir / "sq", 3);
+  S21TiledMatrix same_dir(dir / "sq", 5, 5, 3);
+  S21TiledMatrix tiled_sq_c(dir / "sq_c", 5, 5, 3);
+  EXPECT_THROW(S21TiledMatrix::Multiply(tiled_sq, tiled_sq, tiled_sq),
+               std::invalid_argument);
+  EXPECT_THROW(S21TiledMatrix::Multiply(tiled_sq, tiled_sq, same_dir),
+               std::invalid_argument);
+  EXPECT_TRUE(tiled_sq.ToMatrix() == square);
+
+  // Ошибка фонового потока подгрузки доходит до вызывающего
+  std::filesystem::resize_file(dir / "sq" / "tiles.bin", 1);
+  EXPECT_THROW(S21TiledMatrix::Multiply(tiled_sq, tiled_sq, tiled_sq_c),
+               std::runtime_error);
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST(MatrixTest, SmallMatrixStorage) {
+  S21Matrix small(2, 3);
+  small(1, 2) = 6.0;
+  small.SetCopyOnWrite(true);
+
+  S21Matrix copy(small);
+  EXPECT_FALSE(small.IsShared());
+  EXPECT_TRUE(copy.IsCopyOnWrite());
+  copy(1, 2) = 7.0;
+  EXPECT_DOUBLE_EQ(small(1, 2), 6.0);
+
+  S21Matrix moved(std::move(copy));
+  EXPECT_EQ(copy.GetRows(), 0);
+  EXPECT_DOUBLE_EQ(moved(1, 2), 7.0);
+
+  S21Matrix assigned(6, 6);
+  assigned = std::move(moved);
+  EXPECT_EQ(assigned.GetCols(), 3);
+  EXPECT_DOUBLE_EQ(assigned(1, 2), 7.0);
+
+  // Рост за пределы встроенного буфера и обратно
+  assigned.SetRows(10);
+  assigned(9, 0) = 1.0;
+  EXPECT_DOUBLE_EQ(assigned(1, 2), 7.0);
+  S21Matrix back = assigned;
+  back.SetRows(2);
+  S21Matrix small_copy = back;
+  EXPECT_EQ(small_copy.GetRows(), 2);
+  EXPECT_DOUBLE_EQ(small_copy(1, 2), 7.0);
+  EXPECT_DOUBLE_EQ(small_copy(0, 0), 0.0);
+
+  S21Matrix product = small * small.Transpose();
+  EXPECT_DOUBLE_EQ(product(1, 1), 36.0);
+}
+
+TEST(MatrixTest, SmallDeterminantAndInverse) {
+  const double values[4][4] = {{2.0, -1.0, 0.0, 3.0},
+                               {1.0, 4.0, -2.0, 0.5},
+                               {0.0, 3.0, 5.0, -1.0},
+                               {-2.0, 1.0, 1.0, 6.0}};
+  const double determinants[] = {2.0, 9.0, 57.0, 516.0};
+
+  for (int n = 1; n <= 4; n++) {
+    S21Matrix matrix(n, n);
+    S21Matrix identity(n, n);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) matrix(i, j) = values[i][j];
+      identity(i, i) = 1.0;
+    }
+
+    EXPECT_NEAR(matrix.Determinant(), determinants[n - 1], 1e-12);
+    S21Matrix inverse = matrix.InverseMatrix();
+    EXPECT_TRUE(matrix * inverse == identity);
+    EXPECT_TRUE(inverse.InverseMatrix() == matrix);
+  }
+
+  S21Matrix singular(4, 4);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) singular(i, j) = i + j;
+  }
+  EXPECT_DOUBLE_EQ(singular.Determinant(), 0.0);
+  EXPECT_THROW(singular.InverseMatrix(), std::logic_error);
+
+  S21Matrix zero(1, 1);
+  EXPECT_THROW(zero.InverseMatrix(), std::logic_error);
+}
+
+TEST(MatrixTest, AsyncOperations) {
+  const int n = 7;
+  S21Matrix a(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) a(i, j) = std::cos(i * 1.3 + j * 0.7);
+    a(i, i) += 3.0;
+  }
+
+  auto control = std::make_shared<S21AsyncControl>();
+  std::future<S21Matrix> product = a.MulAsync(a, control);
+  std::future<S21Matrix> inverse = a.InverseAsync();
+  std::future<double> determinant = a.DeterminantAsync();
+
+  EXPECT_TRUE(product.get() == a * a);
+  EXPECT_DOUBLE_EQ(control->Progress(), 1.0);
+  // Те же LuFactor, LuDeterminant и LuInvert: совпадение точное
+  const S21Matrix async_inverse = inverse.get();
+  const S21Matrix sync_inverse = a.InverseMatrix();
+  EXPECT_TRUE(std::equal(async_inverse.begin(), async_inverse.end(),
+                         sync_inverse.begin()));
+  EXPECT_EQ(determinant.get(), a.Determinant());
+
+  S21Matrix small(2, 2);
+  small(0, 0) = 2.0;
+  small(1, 1) = 4.0;
+  EXPECT_DOUBLE_EQ(small.DeterminantAsync().get(), 8.0);
+  EXPECT_DOUBLE_EQ(small.InverseAsync().get()(1, 1), 0.25);
+
+  S21Matrix singular(5, 5);
+  EXPECT_DOUBLE_EQ(singular.DeterminantAsync().get(), 0.0);
+  EXPECT_THROW(singular.InverseAsync().get(), std::logic_error);
+
+  S21Matrix wrong(3, 2);
+  EXPECT_THROW(a.MulAsync(wrong), std::invalid_argument);
+  EXPECT_THROW(wrong.InverseAsync(), std::logic_error);
+
+  // Задач больше, чем потоков в пуле: лишние ждут в очереди
+  std::vector<std::future<double>> many;
+  for (int k = 0; k < 64; k++) many.push_back(a.DeterminantAsync());
+  for (std::future<double>& result : many) {
+    EXPECT_NEAR(result.get(), a.Determinant(), 1e-9);
+  }
+}
+
+TEST(MatrixTest, AsyncCancellation) {
+  S21Matrix a(6, 6);
+  auto control = std::make_shared<S21AsyncControl>();
+  control->Cancel();
+  EXPECT_TRUE(control->IsCancelled());
+
+  EXPECT_THROW(a.MulAsync(a, control).get(), S21OperationCancelled);
+  EXPECT_THROW(a.InverseAsync(control).get(), S21OperationCancelled);
+  EXPECT_THROW(a.DeterminantAsync(control).get(), S21OperationCancelled);
+}
+
+TEST(MatrixTest, ApplyAndZip) {
+  S21Matrix matrix(2, 3);
+  matrix(0, 0) = -1.5;
+  matrix(0, 1) = 2.0;
+  matrix(1, 2) = -3.0;
+
+  matrix.Apply([](double x) { return x > 0.0 ? x : 0.0; });
+  EXPECT_DOUBLE_EQ(matrix(0, 0), 0.0);
+  EXPECT_DOUBLE_EQ(matrix(0, 1), 2.0);
+  EXPECT_DOUBLE_EQ(matrix(1, 2), 0.0);
+
+  S21Matrix other(2, 3);
+  other(0, 1) = 5.0;
+  other(1, 0) = -1.0;
+  matrix.Zip(other, [](double x, double y) { return std::max(x, y); })
+      .Apply([](double x) { return x * 2.0; });
+  EXPECT_DOUBLE_EQ(matrix(0, 1), 10.0);
+  EXPECT_DOUBLE_EQ(matrix(1, 0), 0.0);
+
+  S21Matrix wrong(3, 2);
+  EXPECT_THROW(matrix.Zip(wrong, [](double x, double) { return x; }),
+               std::invalid_argument);
+
+  S21Matrix large(400, 300);
+  large.Apply([](double) { return 1.5; });
+  large.Zip(large, [](double x, double y) { return x * y; });
+  EXPECT_DOUBLE_EQ(large.Sum(), 400 * 300 * 2.25);
+
+  // Исключение из последнего блока (в параллельном режиме — из рабочего
+  // потока) доходит до вызывающего
+  large.SetRows(512);
+  large.SetCols(512);
+  large(511, 511) = -1.0;
+  auto check_sign = [](double x) {
+    if (x < 0.0) throw std::domain_error("Отрицательный элемент");
+    return x;
+  };
+  EXPECT_THROW(large.Apply(check_sign), std::domain_error);
+  EXPECT_THROW(
+      large.Zip(large, [&](double x, double) { return check_sign(x); }),
+      std::domain_error);
+}
+
+// SumMatrix, SubMatrix и MulNumber идут через Zip и Apply. На малых
+// матрицах они не должны платить за распараллеливание: при регрессии
+// итерация занимала около 10 мкс, без неё — десятки наносекунд
+TEST(MatrixTest, SmallElementwiseCost) {
+  S21Matrix a(2, 2);
+  S21Matrix b(2, 2);
+  b(0, 1) = 1.0;
+
+  const int iterations = 100000;
+  const auto start = std::chrono::steady_clock::now();
+  for (int k = 0; k < iterations; k++) {
+    a.SumMatrix(b);
+    a.SubMatrix(b);
+    a.MulNumber(1.0);
+  }
+  const std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  EXPECT_DOUBLE_EQ(a(0, 1), 0.0);
+  EXPECT_LT(elapsed.count() / iterations, 2.0);
+}
+
+TEST(MatrixTest, VectorizedTranscendentals) {
+  // 7 столбцов: пачка из четырёх элементов и скалярный хвост
+  S21Matrix x(3, 7);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 7; j++) x(i, j) = (i * 7 + j - 10) * 1.37;
+  }
+
+  S21Matrix exp_x = x, tanh_x = x, sigmoid_x = x;
+  exp_x.ApplyExp();
+  tanh_x.ApplyTanh();
+  sigmoid_x.ApplySigmoid();
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 7; j++) {
+      const double v = x(i, j);
+      EXPECT_NEAR(exp_x(i, j), std::exp(v), 4e-16 * std::exp(v));
+      EXPECT_NEAR(tanh_x(i, j), std::tanh(v), 1e-15);
+      EXPECT_NEAR(sigmoid_x(i, j), 1.0 / (1.0 + std::exp(-v)), 1e-15);
+    }
+  }
+
+  S21Matrix log_x = exp_x;
+  log_x.ApplyLog();
+  for (int j = 0; j < 7; j++) {
+    EXPECT_NEAR(log_x(2, j), x(2, j), 1e-14);
+  }
+
+  S21Matrix special(1, 5);
+  special(0, 0) = std::numeric_limits<double>::quiet_NaN();
+  special(0, 1) = 800.0;
+  special(0, 2) = -800.0;
+  special(0, 3) = 0.0;
+  special(0, 4) = -1.0;
+  S21Matrix special_exp = special;
+  special_exp.ApplyExp();
+  EXPECT_TRUE(std::isnan(special_exp(0, 0)));
+  EXPECT_TRUE(std::isinf(special_exp(0, 1)));
+  EXPECT_EQ(special_exp(0, 2), 0.0);
+  special.ApplyLog();
+  EXPECT_TRUE(std::isnan(special(0, 0)));
+  EXPECT_EQ(special(0, 3), -std::numeric_limits<double>::infinity());
+  EXPECT_TRUE(std::isnan(special(0, 4)));
+}
+
+TEST(MatrixTest, VectorizedAccuracy) {
+  // Строка 1 x n обрабатывается пачками (если процессор поддерживает AVX2
+  // и FMA), столбец n x 1 — функциями libm. Ошибка в ULP против long double
+  // должна укладываться в границы из s21_vector_math.h
+  auto ulp = [](double value, long double exact) {
+    const double rounded = static_cast<double>(exact);
+    if (value == rounded) return 0.0;
+    const double step =
+        std::nextafter(std::fabs(rounded), INFINITY) - std::fabs(rounded);
+    return static_cast<double>(std::fabs(value - exact) / step);
+  };
+  auto check = [&](auto apply, long double (*exact)(long double), double lo,
+                   double hi, bool log_scale, double bound) {
+    const int n = 4099;
+    S21Matrix row(1, n), col(n, 1);
+    for (int k = 0; k < n; k++) {
+      const double t = lo + (hi - lo) * std::fmod(k * 0.6180339887498949, 1);
+      row(0, k) = col(k, 0) = log_scale ? std::exp2(t) : t;
+    }
+    const S21Matrix x = row;
+    apply(row);
+    apply(col);
+
+    double worst_row = 0.0, worst_col = 0.0;
+    bool differs = false;
+    for (int k = 0; k < n; k++) {
+      const long double reference = exact(x(0, k));
+      worst_row = std::max(worst_row, ulp(row(0, k), reference));
+      worst_col = std::max(worst_col, ulp(col(k, 0), reference));
+      differs = differs || row(0, k) != col(k, 0);
+    }
+    EXPECT_LT(worst_row, bound);
+    EXPECT_LT(worst_col, bound);
+#ifdef S21_VECTOR_MATH_AVX2
+    // Пачки действительно выполнялись: их результаты отличаются от libm
+    if (s21_vector_math::HasAvx2()) {
+      EXPECT_TRUE(differs);
+    }
+#endif
+  };
+
+  check([](S21Matrix& m) { m.ApplyExp(); }, expl, -700, 700, false, 1.0);
+  check([](S21Matrix& m) { m.ApplyLog(); }, logl, -1000, 1000, true, 1.0);
+  check([](S21Matrix& m) { m.ApplyTanh(); }, tanhl, -3, 3, false, 3.0);
+  check([](S21Matrix& m) { m.ApplySigmoid(); },
+        [](long double v) { return 1.0L / (1.0L + expl(-v)); }, -40, 40,
+        false, 2.5);
+
+  // Особые значения в пачке: NaN и большие аргументы до ограничения
+  const double inf = std::numeric_limits<double>::infinity();
+  const double special[] = {NAN, 1e300, -1e300, inf, -inf, 0.0, -0.0, 25.0};
+  S21Matrix tanh_x(1, 8), sigmoid_x(1, 8);
+  for (int j = 0; j < 8; j++) tanh_x(0, j) = sigmoid_x(0, j) = special[j];
+  tanh_x.ApplyTanh();
+  sigmoid_x.ApplySigmoid();
+  EXPECT_TRUE(std::isnan(tanh_x(0, 0)));
+  EXPECT_TRUE(std::isnan(sigmoid_x(0, 0)));
+  for (int j = 1; j < 8; j++) {
+    EXPECT_EQ(tanh_x(0, j), std::tanh(special[j]));
+    EXPECT_EQ(sigmoid_x(0, j), 1.0 / (1.0 + std::exp(-special[j])));
+  }
+  EXPECT_TRUE(std::signbit(tanh_x(0, 6)));
+}
+
+TEST(MatrixTest, SoftmaxRows) {
+  S21Matrix logits(2, 5);
+  for (int j = 0; j < 5; j++) {
+    logits(0, j) = j;
+    logits(1, j) = 1000.0 + j;
+  }
+
+  logits.SoftmaxRows();
+  double denominator = 0.0;
+  for (int j = 0; j < 5; j++) denominator += std::exp(j - 4.0);
+  for (int j = 0; j < 5; j++) {
+    EXPECT_NEAR(logits(0, j), std::exp(j - 4.0) / denominator, 1e-15);
+    EXPECT_NEAR(logits(1, j), logits(0, j), 1e-15);
+  }
+  EXPECT_NEAR(logits.RowSums()(1, 0), 1.0, 1e-15);
+}
+
+TEST(MatrixTest, BroadcastOperations) {
+  S21Matrix matrix(3, 5);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 5; j++) matrix(i, j) = i * 5 + j;
+  }
+
+  S21Matrix row(1, 5), col(3, 1);
+  for (int j = 0; j < 5; j++) row(0, j) = j + 1.0;
+  for (int i = 0; i < 3; i++) col(i, 0) = -2.0 * i;
+
+  S21Matrix expected = matrix;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 5; j++) {
+      expected(i, j) = (expected(i, j) + row(0, j) + col(i, 0)) * col(i, 0) *
+                       row(0, j);
+    }
+  }
+  matrix.AddRowVector(row).AddColVector(col).ScaleRows(col).ScaleCols(row);
+  EXPECT_TRUE(matrix == expected);
+
+  EXPECT_THROW(matrix.AddRowVector(col), std::invalid_argument);
+  EXPECT_THROW(matrix.ScaleRows(row), std::invalid_argument);
+
+  matrix.SubtractColMeans();
+  S21Matrix means = matrix.ColMeans();
+  for (int j = 0; j < 5; j++) EXPECT_NEAR(means(0, j), 0.0, 1e-12);
+
+  S21Matrix empty;
+  EXPECT_THROW(empty.SubtractColMeans(), std::logic_error);
+}
+
+TEST(MatrixTest, MultiplyChain) {
+  // Высокая, широкая, высокая, широкая: порядок слева направо здесь
+  // в десятки раз дороже оптимального
+  S21Matrix a(40, 2), b(2, 30), c(30, 3), d(3, 25);
+  for (int i = 0; i < 40; i++) {
+    for (int j = 0; j < 2; j++) a(i, j) = (i + j) % 5 - 2.0;
+  }
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 30; j++) b(i, j) = (i * j) % 7 - 3.0;
+  }
+  for (int i = 0; i < 30; i++) {
+    for (int j = 0; j < 3; j++) c(i, j) = (2 * i + j) % 3 - 1.0;
+  }
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 25; j++) d(i, j) = (i + 3 * j) % 4 - 1.5;
+  }
+
+  S21Matrix expected = a * b * c * d;
+  S21Matrix result = S21Matrix::MultiplyChain({a, b, c, d});
+  ASSERT_EQ(result.GetRows(), 40);
+  ASSERT_EQ(result.GetCols(), 25);
+  EXPECT_TRUE(result == expected);
+
+  EXPECT_TRUE(S21Matrix::MultiplyChain({a}) == a);
+  EXPECT_TRUE(S21Matrix::MultiplyChain({b, c}) == b * c);
+  EXPECT_THROW(S21Matrix::MultiplyChain({a, c}), std::invalid_argument);
+  EXPECT_THROW(S21Matrix::MultiplyChain({}), std::invalid_argument);
+}
+
+TEST(MatrixTest, TransposedOperands) {
+  S21Matrix a(9, 6), b(9, 5), c(5, 6);
+  for (int i = 0; i < 9; i++) {
+    for (int j = 0; j < 6; j++) a(i, j) = (i * 6 + j) % 7 - 3.0;
+    for (int j = 0; j < 5; j++) b(i, j) = (i + 2 * j) % 5 - 2.0;
+  }
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 6; j++) c(i, j) = (3 * i + j) % 4 - 1.0;
+  }
+
+  S21Matrix::TransposedView at = a.Transposed();
+  EXPECT_EQ(at.GetRows(), 6);
+  EXPECT_EQ(at.GetCols(), 9);
+  EXPECT_DOUBLE_EQ(at(4, 7), a(7, 4));
+
+  // TN, NT и TT против явного транспонирования
+  EXPECT_TRUE(at * b == a.Transpose() * b);
+  S21Matrix d = c.Transpose();
+  EXPECT_TRUE(b * d.Transposed() == b * c);
+  EXPECT_TRUE(c.Transposed() * b.Transposed() ==
+              c.Transpose() * b.Transpose());
+
+  S21Matrix accumulated = a.Transpose() * b;
+  accumulated.Gemm(2.0, at, b, -1.0);
+  EXPECT_TRUE(accumulated == a.Transpose() * b);
+  EXPECT_THROW(accumulated.Gemm(1.0, a, b.Transposed(), 0.0),
+               std::invalid_argument);
+
+  S21Matrix x(9, 1), y(6, 1);
+  for (int i = 0; i < 9; i++) x(i, 0) = i - 4.0;
+  y.Gemv(1.0, at, x, 0.0);
+  EXPECT_TRUE(y == a.Transpose() * x);
+  S21Matrix z(9, 1);
+  z.Gemv(1.0, a, y, 0.0);
+  EXPECT_TRUE(z == a * y);
+  EXPECT_THROW(z.Gemv(1.0, at, x, 0.0), std::invalid_argument);
+}
+
+TEST(MatrixTest, TransposedSolve) {
+  S21Matrix a(5, 5), b(5, 2);
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) a(i, j) = 1.0 / (i + 2 * j + 1);
+    a(i, i) += 3.0;
+    b(i, 0) = i + 1.0;
+    b(i, 1) = 1.0 - i;
+  }
+
+  for (auto mode : {S21Matrix::SolveMode::kDouble,
+                    S21Matrix::SolveMode::kMixed}) {
+    S21Matrix x = a.Transposed().Solve(b, mode);
+    S21Matrix residual = a.Transposed() * x - b;
+    EXPECT_LT(residual.NormInf(), 1e-13);
+    EXPECT_TRUE(x == a.Transpose().Solve(b, mode));
+  }
+}
+
+TEST(MatrixTest, SymmetricRankKUpdate) {
+  // 70 столбцов: несколько блоков по 64
+  S21Matrix a(30, 70);
+  for (int i = 0; i < 30; i++) {
+    for (int j = 0; j < 70; j++) a(i, j) = (i * 3 + j * 5) % 9 - 4.0;
+  }
+
+  S21Matrix gram = a.Gram();
+  EXPECT_TRUE(gram == a.Transpose() * a);
+
+  S21Matrix outer(30, 30);
+  outer.SymmetricRankKUpdate(1.0, a, 0.0);
+  EXPECT_TRUE(outer == a * a.Transpose());
+
+  S21Matrix updated = outer;
+  updated.SymmetricRankKUpdate(-2.0, a, 3.0);
+  EXPECT_TRUE(updated == outer);
+
+  EXPECT_THROW(outer.SymmetricRankKUpdate(1.0, a.Transposed(), 0.0),
+               std::invalid_argument);
+}
+
+TEST(MatrixTest, Covariance) {
+  S21Matrix samples(4, 2);
+  const double values[4][2] = {{1.0, 2.0}, {2.0, 1.0}, {3.0, 4.0}, {6.0, 5.0}};
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 2; j++) samples(i, j) = values[i][j];
+  }
+
+  // Средние 3 и 3, отклонения (-2, -1), (-1, -2), (0, 1), (3, 2)
+  S21Matrix covariance = samples.Covariance();
+  EXPECT_NEAR(covariance(0, 0), 14.0 / 3.0, 1e-15);
+  EXPECT_NEAR(covariance(1, 1), 10.0 / 3.0, 1e-15);
+  EXPECT_NEAR(covariance(0, 1), 10.0 / 3.0, 1e-15);
+  EXPECT_DOUBLE_EQ(covariance(1, 0), covariance(0, 1));
+
+  S21Matrix single(1, 3);
+  EXPECT_THROW(single.Covariance(), std::logic_error);
+}
+
+TEST(MatrixTest, CachedFactorization) {
+  // Верхнетреугольная 6x6: определитель — произведение диагонали
+  S21Matrix a(6, 6);
+  for (int i = 0; i < 6; i++) {
+    a(i, i) = i + 1.0;
+    if (i + 1 < 6) a(i, i + 1) = 1.0;
+  }
+
+  S21Matrix identity(6, 6);
+  for (int i = 0; i < 6; i++) identity(i, i) = 1.0;
+
+  const S21Matrix& view = a;
+  EXPECT_DOUBLE_EQ(view.Determinant(), 720.0);
+  EXPECT_DOUBLE_EQ(view.Determinant(), 720.0);
+  EXPECT_TRUE(a * view.InverseMatrix() == identity);
+
+  a.SetElement(0, 0, 2.0);
+  EXPECT_DOUBLE_EQ(view.Determinant(), 1440.0);
+  a(5, 5) = 12.0;
+  EXPECT_DOUBLE_EQ(view.Determinant(), 2880.0);
+  EXPECT_TRUE(a * view.InverseMatrix() == identity);
+
+  a.SumMatrix(identity);
+  EXPECT_DOUBLE_EQ(view.Determinant(), 3.0 * 3 * 4 * 5 * 6 * 13);
+  EXPECT_TRUE(view.Solve(identity) == view.InverseMatrix());
+
+  // Дополнения через обратную совпадают с явным транспонированием
+  S21Matrix complements = view.CalcComplements();
+  EXPECT_TRUE(complements.Transpose() * a ==
+              identity * view.Determinant());
+
+  S21Matrix copy = a;
+  EXPECT_DOUBLE_EQ(copy.Determinant(), view.Determinant());
+
+  a.SetRows(5);
+  EXPECT_THROW(view.Determinant(), std::logic_error);
+
+  // Маленькие ведущие элементы — не вырожденность
+  S21Matrix scaled(6, 6);
+  for (int i = 0; i < 6; i++) scaled(i, i) = 0.01;
+  EXPECT_NEAR(scaled.Determinant(), 1e-12, 1e-24);
+  EXPECT_DOUBLE_EQ(scaled.InverseMatrix()(3, 3), 100.0);
+
+  // Один критерий для явных формул n <= 4 и LU при n > 4
+  for (int n = 1; n <= 6; n++) {
+    S21Matrix small(n, n);
+    for (int i = 0; i < n; i++) small(i, i) = 0.001;
+    EXPECT_DOUBLE_EQ(small.InverseMatrix()(n - 1, n - 1), 1000.0);
+  }
+  S21Matrix singular(4, 4);
+  for (int i = 0; i < 3; i++) singular(i, i) = 1.0;
+  EXPECT_THROW(singular.InverseMatrix(), std::logic_error);
+
+  // A^T x = b решается по кэшированному разложению A с перестановками
+  S21Matrix pivoted(5, 5);
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) pivoted(i, j) = std::cos(i * (j + 1.3) + j);
+  }
+  double& corner = pivoted(0, 0);
+  const S21Matrix& cached = pivoted;
+  S21Matrix rhs(5, 2);
+  for (int i = 0; i < 5; i++) {
+    rhs(i, 0) = i + 1.0;
+    rhs(i, 1) = 1.0 - i * i;
+  }
+  const double det = cached.Determinant();
+  S21Matrix x = cached.Transposed().Solve(rhs);
+  EXPECT_LT((cached.Transpose() * x - rhs).NormInf(), 1e-12);
+  // Запись через ссылку, полученную до запроса, кэш не сбрасывает:
+  // повторное решение совпадает, значит разложение не строилось заново
+  corner += 1.0;
+  EXPECT_TRUE(cached.Transposed().Solve(rhs) == x);
+  EXPECT_DOUBLE_EQ(cached.Determinant(), det);
+}
+
+TEST(MatrixTest, Pow) {
+  S21Matrix fibonacci(2, 2);
+  fibonacci(0, 0) = 1.0;
+  fibonacci(0, 1) = 1.0;
+  fibonacci(1, 0) = 1.0;
+
+  S21Matrix power = fibonacci.Pow(10);
+  EXPECT_DOUBLE_EQ(power(0, 0), 89.0);
+  EXPECT_DOUBLE_EQ(power(0, 1), 55.0);
+  EXPECT_DOUBLE_EQ(power(1, 1), 34.0);
+
+  S21Matrix identity(2, 2);
+  identity(0, 0) = 1.0;
+  identity(1, 1) = 1.0;
+  EXPECT_TRUE(fibonacci.Pow(0) == identity);
+  EXPECT_TRUE(fibonacci.Pow(-3) * fibonacci.Pow(3) == identity);
+
+  // Сравнение с последовательным умножением на матрице 6x6
+  S21Matrix a(6, 6);
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 6; j++) a(i, j) = ((i * 5 + j * 3) % 7 - 3.0) / 8.0;
+  }
+  S21Matrix expected = a;
+  for (int k = 1; k < 13; k++) expected *= a;
+  EXPECT_TRUE(a.Pow(13) == expected);
+
+  S21Matrix rectangular(2, 3);
+  EXPECT_THROW(rectangular.Pow(2), std::logic_error);
+}
+
+TEST(MatrixTest, Exp) {
+  // Диагональная: экспоненты элементов; норма 3 требует масштабирования
+  S21Matrix diagonal(3, 3);
+  diagonal(0, 0) = 1.0;
+  diagonal(1, 1) = -3.0;
+  diagonal(2, 2) = 0.001;
+  S21Matrix exp_diagonal = diagonal.Exp();
+  EXPECT_NEAR(exp_diagonal(0, 0), exp(1.0), 1e-15 * exp(1.0));
+  EXPECT_NEAR(exp_diagonal(1, 1), exp(-3.0), 1e-15);
+  EXPECT_NEAR(exp_diagonal(2, 2), exp(0.001), 1e-15);
+  EXPECT_EQ(exp_diagonal(0, 1), 0.0);
+
+  // exp([[0, -t], [t, 0]]) — поворот на угол t
+  S21Matrix rotation(2, 2);
+  rotation(0, 1) = -10.0;
+  rotation(1, 0) = 10.0;
+  S21Matrix turned = rotation.Exp();
+  EXPECT_NEAR(turned(0, 0), cos(10.0), 1e-13);
+  EXPECT_NEAR(turned(1, 0), sin(10.0), 1e-13);
+  EXPECT_NEAR(turned(0, 1), -sin(10.0), 1e-13);
+
+  // Нильпотентная: ряд обрывается, I + N + N^2 / 2
+  S21Matrix nilpotent(3, 3);
+  nilpotent(0, 1) = 0.01;
+  nilpotent(1, 2) = 0.01;
+  S21Matrix exp_nilpotent = nilpotent.Exp();
+  EXPECT_NEAR(exp_nilpotent(0, 2), 0.00005, 1e-18);
+  EXPECT_NEAR(exp_nilpotent(0, 1), 0.01, 1e-18);
+
+  // exp(A) exp(-A) = I на плотной матрице
+  S21Matrix a(10, 10);
+  for (int i = 0; i < 10; i++) {
+    for (int j = 0; j < 10; j++) a(i, j) = ((i * 7 + j * 4) % 9 - 4.0) / 3.0;
+  }
+  S21Matrix identity(10, 10);
+  for (int i = 0; i < 10; i++) identity(i, i) = 1.0;
+  S21Matrix product = a.Exp() * (-1.0 * a).Exp();
+  EXPECT_TRUE(product == identity);
+
+  S21Matrix rectangular(2, 3);
+  EXPECT_THROW(rectangular.Exp(), std::logic_error);
+}
+
+TEST(MatrixTest, Qr) {
+  // Высокая (больше одной панели по 32 столбца) и широкая матрицы
+  for (auto [rows, cols] : {pair{90, 40}, pair{5, 8}}) {
+    S21Matrix a(rows, cols);
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < cols; j++) {
+        a(i, j) = ((i * 11 + j * 7) % 13 - 6.0) / 4.0 + (i == j ? 3.0 : 0.0);
+      }
+    }
+
+    auto [q, r] = a.Qr();
+    const int k = min(rows, cols);
+    ASSERT_EQ(q.GetCols(), k);
+    ASSERT_EQ(r.GetRows(), k);
+
+    S21Matrix identity(k, k);
+    for (int i = 0; i < k; i++) identity(i, i) = 1.0;
+    S21Matrix gram(k, k);
+    gram.Gemm(1.0, q.Transposed(), q, 0.0);
+    EXPECT_TRUE(gram == identity);
+    EXPECT_TRUE(q * r == a);
+    for (int i = 1; i < k; i++) EXPECT_EQ(r(i, i - 1), 0.0);
+  }
+}
+
+TEST(MatrixTest, LeastSquares) {
+  // Точные данные y = 2 - x + 0.5 x^2 во втором столбце правой части
+  // и зашумлённые в первом; для шума остаток ортогонален столбцам A
+  for (int rows : {50, 5000}) {
+    S21Matrix a(rows, 3), b(rows, 2);
+    for (int i = 0; i < rows; i++) {
+      const double x = 4.0 * i / rows - 2.0;
+      a(i, 0) = 1.0;
+      a(i, 1) = x;
+      a(i, 2) = x * x;
+      b(i, 1) = 2.0 - x + 0.5 * x * x;
+      b(i, 0) = b(i, 1) + 0.1 * ((i * 37) % 11 - 5.0);
+    }
+
+    S21Matrix x = a.LeastSquares(b);
+    EXPECT_NEAR(x(0, 1), 2.0, 1e-12);
+    EXPECT_NEAR(x(1, 1), -1.0, 1e-12);
+    EXPECT_NEAR(x(2, 1), 0.5, 1e-12);
+
+    S21Matrix residual = b;
+    residual.Gemm(-1.0, a, x, 1.0);
+    S21Matrix normal(3, 2);
+    normal.Gemm(1.0, a.Transposed(), residual, 0.0);
+    EXPECT_LT(normal.NormInf(), 1e-9 * rows);
+  }
+
+  S21Matrix dependent(6, 2), rhs(6, 1);
+  for (int i = 0; i < 6; i++) {
+    dependent(i, 0) = i;
+    dependent(i, 1) = 2.0 * i;
+  }
+  EXPECT_THROW(dependent.LeastSquares(rhs), std::logic_error);
+  EXPECT_THROW(dependent.Transpose().LeastSquares(rhs), std::invalid_argument);
+}
+
+TEST(MatrixTest, RandomizedSvd) {
+  // Строки переставлены: сингулярные числа — 2^-i, i = 0..29
+  S21Matrix scaled(50, 30);
+  for (int i = 0; i < 30; i++) scaled((i * 7) % 50, i) = ldexp(1.0, -i);
+
+  auto [u, s, v] = scaled.RandomizedSvd(4);
+  ASSERT_EQ(s.GetRows(), 4);
+  for (int i = 0; i < 4; i++) EXPECT_NEAR(s(i, 0), ldexp(1.0, -i), 1e-12);
+
+  S21Matrix identity(4, 4);
+  for (int i = 0; i < 4; i++) identity(i, i) = 1.0;
+  EXPECT_TRUE(u.Transposed() * u == identity);
+  EXPECT_TRUE(v.Transposed() * v == identity);
+
+  // Матрица ранга 3 восстанавливается точно
+  S21Matrix left(60, 3), right(40, 3);
+  for (int i = 0; i < 60; i++) {
+    for (int j = 0; j < 3; j++) left(i, j) = (i * (j + 2)) % 7 - 3.0;
+  }
+  for (int i = 0; i < 40; i++) {
+    for (int j = 0; j < 3; j++) right(i, j) = (i + 5 * j) % 5 - 2.0;
+  }
+  S21Matrix low_rank = left * right.Transposed();
+
+  auto [u3, s3, v3] = low_rank.RandomizedSvd(3, 5, 1);
+  S21Matrix restored = u3;
+  restored.ScaleCols(s3.Transpose());
+  restored = restored * v3.Transposed();
+  S21Matrix difference = restored - low_rank;
+  EXPECT_LT(difference.FrobeniusNorm(), 1e-11 * low_rank.FrobeniusNorm());
+
+  EXPECT_THROW(low_rank.RandomizedSvd(0), std::invalid_argument);
+  EXPECT_THROW(low_rank.RandomizedSvd(41), std::invalid_argument);
+}
+
+TEST(PackedMatrixTest, Triangular) {
+  using Part = S21TriangularMatrix::Part;
+  S21Matrix dense(4, 4);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) dense(i, j) = i == j ? 2.0 + i : i + j + 1.0;
+  }
+
+  for (Part part : {Part::kLower, Part::kUpper}) {
+    S21TriangularMatrix t = S21TriangularMatrix::FromMatrix(dense, part);
+    S21Matrix full = t.ToMatrix();
+    for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 4; j++) {
+        const bool stored = part == Part::kLower ? j <= i : j >= i;
+        EXPECT_DOUBLE_EQ(full(i, j), stored ? dense(i, j) : 0.0);
+        EXPECT_DOUBLE_EQ(t.GetElement(i, j), full(i, j));
+      }
+    }
+
+    S21Matrix b(4, 2);
+    for (int i = 0; i < 4; i++) {
+      b(i, 0) = i - 1.0;
+      b(i, 1) = 2.0 * i;
+    }
+    EXPECT_TRUE(t.Multiply(b) == full * b);
+    EXPECT_LT((full * t.Solve(b) - b).NormInf(), 1e-14);
+    EXPECT_LT((full.Transpose() * t.SolveTransposed(b) - b).NormInf(),
+              1e-14);
+    EXPECT_DOUBLE_EQ(t.Determinant(), 2.0 * 3.0 * 4.0 * 5.0);
+  }
+
+  S21TriangularMatrix lower(3, Part::kLower);
+  lower(2, 0) = 1.0;
+  EXPECT_THROW(lower(0, 2) = 1.0, std::out_of_range);
+  EXPECT_THROW(lower.Solve(S21Matrix(3, 1)), std::logic_error);
+  EXPECT_THROW(S21TriangularMatrix(0, Part::kUpper), std::invalid_argument);
+}
+
+TEST(PackedMatrixTest, Symmetric) {
+  S21Matrix a(6, 4);
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 4; j++) a(i, j) = (i * 5 + j * 3) % 7 - 3.0;
+  }
+
+  S21SymmetricMatrix gram = S21SymmetricMatrix::Gram(a);
+  EXPECT_TRUE(gram.ToMatrix() == a.Gram());
+  gram(1, 3) = 7.0;
+  EXPECT_DOUBLE_EQ(gram(3, 1), 7.0);
+
+  S21Matrix dense(3, 3);
+  const double values[3][3] = {{4.0, 2.0, 0.6}, {2.0, 5.0, 1.0},
+                               {0.6, 1.0, 3.0}};
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) dense(i, j) = values[i][j];
+  }
+  S21SymmetricMatrix s = S21SymmetricMatrix::FromMatrix(dense);
+  EXPECT_TRUE(s.ToMatrix() == dense);
+
+  S21TriangularMatrix l = s.Cholesky();
+  EXPECT_LT((l.Multiply(l.ToMatrix().Transpose()) - dense).NormInf(), 1e-14);
+  EXPECT_NEAR(s.Determinant(), dense.Determinant(), 1e-12);
+
+  S21Matrix b(3, 1);
+  b(0, 0) = 1.0;
+  b(2, 0) = -2.0;
+  EXPECT_TRUE(s.Multiply(b) == dense * b);
+  EXPECT_LT((dense * s.Solve(b) - b).NormInf(), 1e-14);
+
+  // Незнакоопределённая матрица решается через плотное LU
+  S21SymmetricMatrix indefinite(2);
+  indefinite(0, 1) = 1.0;
+  EXPECT_THROW(indefinite.Cholesky(), std::logic_error);
+  EXPECT_DOUBLE_EQ(indefinite.Determinant(), -1.0);
+  S21Matrix rhs(2, 1);
+  rhs(0, 0) = 1.0;
+  rhs(1, 0) = 2.0;
+  S21Matrix x = indefinite.Solve(rhs);
+  EXPECT_DOUBLE_EQ(x(0, 0), 2.0);
+  EXPECT_DOUBLE_EQ(x(1, 0), 1.0);
+}
+
+TEST(BandMatrixTest, Tridiagonal) {
+  // -u'' = 1 на сетке из 200000 узлов: прогонка за O(n)
+  const int n = 200000;
+  S21BandMatrix laplace(n, 1, 1);
+  S21Matrix rhs(n, 1);
+  for (int i = 0; i < n; i++) {
+    laplace(i, i) = 2.0;
+    if (i > 0) laplace(i, i - 1) = -1.0;
+    if (i + 1 < n) laplace(i, i + 1) = -1.0;
+    rhs(i, 0) = 1.0;
+  }
+
+  S21Matrix u = laplace.Solve(rhs);
+  // Точное решение дискретной задачи: u_i = (i + 1)(n - i) / 2,
+  // число обусловленности порядка n^2
+  for (int i : {0, 1, n / 3, n / 2, n - 1}) {
+    const double exact = (i + 1.0) * (n - i) / 2.0;
+    EXPECT_NEAR(u(i, 0), exact, 1e-7 * exact);
+  }
+  EXPECT_LT((laplace.Multiply(u) - rhs).NormInf(), 1e-3);
+
+  EXPECT_THROW(laplace(0, 2) = 1.0, std::out_of_range);
+  EXPECT_DOUBLE_EQ(laplace.GetElement(0, 2), 0.0);
+}
+
+TEST(BandMatrixTest, BandedLu) {
+  S21Matrix dense(7, 7);
+  for (int i = 0; i < 7; i++) {
+    for (int j = std::max(0, i - 2); j <= std::min(6, i + 1); j++) {
+      dense(i, j) = (i * 3 + j * 5) % 7 - 3.0;
+    }
+  }
+  S21BandMatrix band = S21BandMatrix::FromMatrix(dense, 2, 1);
+  EXPECT_TRUE(band.ToMatrix() == dense);
+
+  S21Matrix b(7, 2);
+  for (int i = 0; i < 7; i++) {
+    b(i, 0) = i + 1.0;
+    b(i, 1) = 1.0 - i;
+  }
+  EXPECT_TRUE(band.Multiply(b) == dense * b);
+
+  // Нулевая диагональ требует перестановок строк
+  S21Matrix x = band.Solve(b);
+  EXPECT_LT((dense * x - b).NormInf(), 1e-12);
+  EXPECT_NEAR(band.Determinant(), dense.Determinant(), 1e-9);
+
+  // Трёхдиагональная матрица с нулевым ведущим элементом
+  S21BandMatrix swap(2, 1, 1);
+  swap(0, 1) = 1.0;
+  swap(1, 0) = 1.0;
+  S21Matrix rhs(2, 1);
+  rhs(0, 0) = 3.0;
+  rhs(1, 0) = 4.0;
+  S21Matrix x2 = swap.Solve(rhs);
+  EXPECT_DOUBLE_EQ(x2(0, 0), 4.0);
+  EXPECT_DOUBLE_EQ(x2(1, 0), 3.0);
+  EXPECT_DOUBLE_EQ(swap.Determinant(), -1.0);
+
+  EXPECT_THROW(S21BandMatrix(3, 3, 0), std::invalid_argument);
+  EXPECT_THROW(S21BandMatrix(2, 0, 0).Solve(rhs), std::logic_error);
+}
+
+TEST(InverseUpdaterTest, LowRankUpdates) {
+  const int n = 6;
+  S21Matrix a(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) a(i, j) = ((i * 5 + j * 3) % 7 - 3.0) / 10.0;
+    a(i, i) += 4.0;
+  }
+
+  S21InverseUpdater updater(a, 5);
+  for (int step = 0; step < 7; step++) {
+    const int k = step % 2 + 1;
+    S21Matrix u(n, k), v(n, k);
+    for (int i = 0; i < n; i++) {
+      for (int c = 0; c < k; c++) {
+        u(i, c) = ((i + step + c) % 4 - 1.5) / 4.0;
+        v(i, c) = ((2 * i + step * c) % 5 - 2.0) / 5.0;
+      }
+    }
+    updater.Update(u, v);
+    a += u * v.Transpose();
+
+    S21Matrix product = a * updater.GetInverse();
+    for (int i = 0; i < n; i++) product(i, i) -= 1.0;
+    EXPECT_LT(product.NormInf(), 1e-12);
+    EXPECT_NEAR(updater.GetDeterminant(), a.Determinant(),
+                1e-10 * fabs(a.Determinant()));
+  }
+  // Седьмое обновление — второе после пересчёта на пятом
+  EXPECT_EQ(updater.GetUpdatesSinceRefactor(), 2);
+  EXPECT_TRUE(updater.GetMatrix() == a);
+}
+
+TEST(InverseUpdaterTest, SingularUpdate) {
+  S21Matrix a(2, 2);
+  a(0, 0) = 1.0;
+  a(1, 1) = 1.0;
+  S21InverseUpdater updater(a);
+
+  // A - e0 e0^T вырождена: состояние не меняется
+  S21Matrix u(2, 1), v(2, 1);
+  u(0, 0) = 1.0;
+  v(0, 0) = -1.0;
+  EXPECT_THROW(updater.Update(u, v), std::logic_error);
+  EXPECT_TRUE(updater.GetMatrix() == a);
+  EXPECT_DOUBLE_EQ(updater.GetDeterminant(), 1.0);
+
+  EXPECT_THROW(updater.Update(S21Matrix(3, 1), S21Matrix(3, 1)),
+               std::invalid_argument);
+  EXPECT_THROW(updater.SetRefactorInterval(0), std::invalid_argument);
+  EXPECT_THROW(S21InverseUpdater(S21Matrix(2, 3)), std::logic_error);
+}
+
+TEST(SparseMatrixTest, AssembleAndMultiply) {
+  // Повторяющаяся позиция (1, 2) складывается, (0, 0) сокращается до нуля
+  S21SparseMatrix a = S21SparseMatrix::FromTriplets(
+      3, 4, {{1, 2, 1.5}, {0, 3, 2.0}, {1, 2, 0.5}, {2, 0, -1.0},
+             {0, 0, 1.0}, {0, 0, -1.0}});
+  EXPECT_EQ(a.GetNonZeros(), 3);
+  EXPECT_EQ(a(1, 2), 2.0);
+  EXPECT_EQ(a(0, 0), 0.0);
+  EXPECT_THROW(a(3, 0), std::out_of_range);
+  EXPECT_THROW(S21SparseMatrix::FromTriplets(2, 2, {{2, 0, 1.0}}),
+               std::out_of_range);
+
+  S21Matrix dense = a.ToMatrix();
+  EXPECT_EQ(S21SparseMatrix::FromMatrix(dense).GetNonZeros(), 3);
+
+  S21Matrix b(4, 2);
+  for (int i = 0; i < 4; i++) {
+    b(i, 0) = i + 1.0;
+    b(i, 1) = 2.0 - i;
+  }
+  EXPECT_TRUE(a.Multiply(b) == dense * b);
+
+  vector<double> x = {1.0, 2.0, 3.0, 4.0}, y(3);
+  a.MultiplyVector(x, y);
+  EXPECT_DOUBLE_EQ(y[0], 8.0);
+  EXPECT_DOUBLE_EQ(y[1], 6.0);
+  EXPECT_DOUBLE_EQ(y[2], -1.0);
+  EXPECT_THROW(a.MultiplyVector(y, x), std::invalid_argument);
+}
+
+// Пятиточечный оператор Лапласа на сетке side x side
+S21SparseMatrix Laplacian2d(int side) {
+  vector<S21SparseMatrix::Triplet> triplets;
+  for (int i = 0; i < side; i++) {
+    for (int j = 0; j < side; j++) {
+      const int row = i * side + j;
+      triplets.push_back({row, row, 4.0});
+      if (i > 0) triplets.push_back({row, row - side, -1.0});
+      if (i + 1 < side) triplets.push_back({row, row + side, -1.0});
+      if (j > 0) triplets.push_back({row, row - 1, -1.0});
+      if (j + 1 < side) triplets.push_back({row, row + 1, -1.0});
+    }
+  }
+  return S21SparseMatrix::FromTriplets(side * side, side * side, triplets);
+}
+
+TEST(ConjugateGradientTest, SparseAndMatrixFree) {
+  const int side = 40, n = side * side;
+  S21SparseMatrix a = Laplacian2d(side);
+  S21Matrix expected(n, 1);
+  for (int i = 0; i < n; i++) expected(i, 0) = sin(0.01 * i) + 1.0;
+  S21Matrix b = a.Multiply(expected);
+
+  S21ConjugateGradient plain(a);
+  S21Matrix x = plain.Solve(b);
+  EXPECT_TRUE(plain.GetStats().converged);
+  EXPECT_LT(plain.GetStats().residual, 1e-10);
+  EXPECT_TRUE(x == expected);
+
+  S21ConjugateGradient ic(a, S21ConjugateGradient::Preconditioner::
+                                 kIncompleteCholesky);
+  EXPECT_TRUE(ic.Solve(b) == expected);
+  EXPECT_LT(ic.GetStats().iterations, plain.GetStats().iterations / 2);
+
+  // Тот же оператор без хранения матрицы
+  S21ConjugateGradient matrix_free(
+      n, [side](span<const double> v, span<double> y) {
+        for (int i = 0; i < side; i++) {
+          for (int j = 0; j < side; j++) {
+            const int k = i * side + j;
+            y[k] = 4.0 * v[k] - (i > 0 ? v[k - side] : 0.0) -
+                   (i + 1 < side ? v[k + side] : 0.0) -
+                   (j > 0 ? v[k - 1] : 0.0) - (j + 1 < side ? v[k + 1] : 0.0);
+          }
+        }
+      });
+  EXPECT_TRUE(matrix_free.Solve(b) == expected);
+  EXPECT_EQ(matrix_free.GetStats().iterations, plain.GetStats().iterations);
+
+  matrix_free.SetMaxIterations(3);
+  matrix_free.Solve(b);
+  EXPECT_FALSE(matrix_free.GetStats().converged);
+  EXPECT_EQ(matrix_free.GetStats().iterations, 3);
+
+  EXPECT_THROW(plain.Solve(S21Matrix(n + 1, 1)), std::invalid_argument);
+  EXPECT_THROW(plain.SetTolerance(0.0), std::invalid_argument);
+}
+
+TEST(ConjugateGradientTest, DenseJacobi) {
+  // A = D T D: хорошо обусловленная T и плохой масштаб D, который
+  // предобусловливатель Якоби убирает
+  const int n = 200;
+  auto scale = [](int i) { return pow(10.0, (i * 37 % 200) / 50.0); };
+  S21Matrix a(n, n), b(n, 2);
+  for (int i = 0; i < n; i++) {
+    a(i, i) = 2.0 * scale(i) * scale(i);
+    if (i > 0) {
+      a(i, i - 1) = -0.9 * scale(i) * scale(i - 1);
+      a(i - 1, i) = a(i, i - 1);
+    }
+    b(i, 0) = 1.0;
+    b(i, 1) = i;
+  }
+
+  S21ConjugateGradient plain(a);
+  S21ConjugateGradient jacobi(a,
+                              S21ConjugateGradient::Preconditioner::kJacobi);
+  S21Matrix x = jacobi.Solve(b);
+  EXPECT_TRUE(jacobi.GetStats().converged);
+  EXPECT_TRUE(x == a.Solve(b));
+  plain.Solve(b);
+  EXPECT_LT(2 * jacobi.GetStats().iterations, plain.GetStats().iterations);
+
+  S21Matrix indefinite(2, 2);
+  indefinite(0, 0) = 1.0;
+  indefinite(1, 1) = -1.0;
+  EXPECT_THROW(S21ConjugateGradient(indefinite, S21ConjugateGradient::
+                                                    Preconditioner::kJacobi),
+               std::logic_error);
+}
+
+TEST(HalfMatrixTest, Conversions) {
+  using Format = S21HalfMatrix::Format;
+  S21HalfMatrix half(2, 5, Format::kFloat16);
+  EXPECT_EQ(half.GetStorageBytes(), 20u);
+
+  // Точно представимые значения, включая наибольшее и субнормальное
+  const double exact[] = {1.5, -2.0, 65504.0, ldexp(1.0, -24), 0.0};
+  for (int j = 0; j < 5; j++) half.SetElement(0, j, exact[j]);
+  for (int j = 0; j < 5; j++) EXPECT_EQ(half.GetElement(0, j), exact[j]);
+
+  // Округление к чётному, переполнение, NaN
+  half.SetElement(1, 0, 1.0 + ldexp(1.0, -11));
+  half.SetElement(1, 1, 1.0 + 3 * ldexp(1.0, -11));
+  half.SetElement(1, 2, 70000.0);
+  half.SetElement(1, 3, NAN);
+  half.SetElement(1, 4, ldexp(3.0, -26));
+  EXPECT_EQ(half.GetElement(1, 0), 1.0);
+  EXPECT_EQ(half.GetElement(1, 1), 1.0 + ldexp(1.0, -9));
+  EXPECT_EQ(half.GetElement(1, 2), INFINITY);
+  EXPECT_TRUE(std::isnan(half.GetElement(1, 3)));
+  EXPECT_EQ(half.GetElement(1, 4), ldexp(1.0, -24));
+
+  S21HalfMatrix bfloat(1, 3, Format::kBFloat16);
+  bfloat.SetElement(0, 0, 1.0 / 3.0);
+  bfloat.SetElement(0, 1, 1e30);
+  EXPECT_EQ(bfloat.GetElement(0, 0), 0.333984375);
+  EXPECT_NEAR(bfloat.GetElement(0, 1), 1e30, 1e30 / 256);
+  EXPECT_THROW(bfloat.GetElement(1, 0), std::out_of_range);
+
+  // Чуть выше середины между соседними числами: округление через float
+  // дало бы ровно середину и затем чётное (меньшее) число
+  const double above_tie = ldexp(1.0, -40);
+  half.SetElement(0, 0, 1.0 + ldexp(1.0, -11) + above_tie);
+  half.SetElement(0, 1, ldexp(1.0, -25) + ldexp(above_tie, -25));
+  half.SetElement(0, 2, ldexp(1.0, -25));
+  half.SetElement(0, 3, 65520.0 - ldexp(1.0, -30));
+  EXPECT_EQ(half.GetElement(0, 0), 1.0 + ldexp(1.0, -10));
+  EXPECT_EQ(half.GetElement(0, 1), ldexp(1.0, -24));
+  EXPECT_EQ(half.GetElement(0, 2), 0.0);
+  EXPECT_EQ(half.GetElement(0, 3), 65504.0);
+  bfloat.SetElement(0, 2, 1.0 + ldexp(1.0, -8) + above_tie);
+  EXPECT_EQ(bfloat.GetElement(0, 2), 1.0 + ldexp(1.0, -7));
+}
+
+TEST(HalfMatrixTest, RowDecoding) {
+  // ToMatrix распаковывает строки пачками по восемь (F16C, если есть),
+  // GetElement — по одному элементу; результаты должны совпадать
+  for (auto format :
+       {S21HalfMatrix::Format::kFloat16, S21HalfMatrix::Format::kBFloat16}) {
+    S21HalfMatrix half(3, 29, format);
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 29; j++) {
+        half.SetElement(i, j, ldexp((j % 2 ? -1.0 : 1.0) * (7 * i + j + 1),
+                                    (i * 29 + j) % 60 - 40));
+      }
+    }
+    half.SetElement(1, 3, INFINITY);
+    half.SetElement(2, 5, -0.0);
+
+    const S21Matrix rows = half.ToMatrix();
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 29; j++) {
+        EXPECT_EQ(rows(i, j), half.GetElement(i, j));
+      }
+    }
+    EXPECT_TRUE(std::signbit(rows(2, 5)));
+  }
+}
+
+TEST(HalfMatrixTest, Multiply) {
+  // Элементы кратны 1/8 и малы: произведения во float точны
+  S21Matrix a(37, 21), b(21, 3), x(21, 1);
+  for (int i = 0; i < 37; i++) {
+    for (int j = 0; j < 21; j++) a(i, j) = ((i * 5 + j * 3) % 17 - 8) / 8.0;
+  }
+  for (int k = 0; k < 21; k++) {
+    for (int c = 0; c < 3; c++) b(k, c) = (k + c) % 5 - 2.0;
+    x(k, 0) = k % 3 - 1.0;
+  }
+
+  for (auto format :
+       {S21HalfMatrix::Format::kFloat16, S21HalfMatrix::Format::kBFloat16}) {
+    S21HalfMatrix half = S21HalfMatrix::FromMatrix(a, format);
+    EXPECT_TRUE(half.ToMatrix() == a);
+    EXPECT_TRUE(half.Multiply(b) == a * b);
+    EXPECT_TRUE(half.Multiply(x) == a * x);
+    EXPECT_THROW(half.Multiply(a), std::invalid_argument);
+  }
+}
+
+TEST(MatrixTest, ExternalView) {
+  // Матрица 2 x 3 внутри буфера со строками длины 4
+  double buffer[] = {1, 2, 3, -1, 4, 5, 6, -1};
+  S21Matrix view = S21Matrix::View(buffer, 2, 3, 4);
+  EXPECT_TRUE(view.IsView());
+  EXPECT_EQ(view.Data(), buffer);
+  EXPECT_EQ(view.GetColsCapacity(), 4);
+  EXPECT_EQ(view(1, 2), 6);
+
+  // Изменения пишутся в буфер, копия независима
+  view *= 2.0;
+  view(0, 0) = 7;
+  EXPECT_EQ(buffer[0], 7);
+  EXPECT_EQ(buffer[5], 10);
+  EXPECT_EQ(buffer[3], -1);
+  S21Matrix copy = view;
+  EXPECT_FALSE(copy.IsView());
+  copy(0, 1) = 0;
+  EXPECT_EQ(buffer[1], 4);
+
+  // Рост переносит элементы в собственный буфер
+  S21Matrix moved = std::move(view);
+  EXPECT_TRUE(moved.IsView());
+  moved.SetCols(4);
+  EXPECT_FALSE(moved.IsView());
+  EXPECT_EQ(moved(1, 2), 12);
+  EXPECT_EQ(moved(1, 3), 0);
+  EXPECT_EQ(buffer[7], -1);
+
+  // Константный буфер копируется при первой записи
+  const double constant[] = {4, 7, 2, 6};
+  S21Matrix read_only = S21Matrix::View(constant, 2, 2);
+  EXPECT_EQ(read_only.Determinant(), 10);
+  read_only(0, 0) = 5;
+  EXPECT_FALSE(read_only.IsView());
+  EXPECT_EQ(read_only.Determinant(), 16);
+  EXPECT_EQ(constant[0], 4);
+
+  // Квадратный множитель пишет произведение в буфер, смена размера
+  // переносит результат в собственный буфер
+  double product[] = {1, 2, 3, 4};
+  S21Matrix product_view = S21Matrix::View(product, 2, 2);
+  S21Matrix swap_cols(2, 2);
+  swap_cols(0, 1) = 1;
+  swap_cols(1, 0) = 1;
+  product_view *= swap_cols;
+  EXPECT_TRUE(product_view.IsView());
+  EXPECT_EQ(product[0], 2);
+  EXPECT_EQ(product[3], 3);
+  product_view *= S21Matrix(2, 3);
+  EXPECT_FALSE(product_view.IsView());
+  EXPECT_EQ(product_view.GetCols(), 3);
+  EXPECT_EQ(product[0], 2);
+
+  // Разложение представления не кэшируется: буфер меняется в обход матрицы
+  double square[25] = {};
+  for (int i = 0; i < 5; i++) square[i * 6] = 2;
+  const S21Matrix square_view = S21Matrix::View(square, 5, 5);
+  EXPECT_EQ(square_view.Determinant(), 32);
+  square[0] = 4;
+  EXPECT_EQ(square_view.Determinant(), 64);
+  EXPECT_EQ(square_view.InverseMatrix()(0, 0), 0.25);
+
+  // То же после выдачи указателя через Data()
+  S21Matrix owned(5, 5);
+  for (int i = 0; i < 5; i++) owned(i, i) = 2;
+  double* data = owned.Data();
+  EXPECT_EQ(std::as_const(owned).Determinant(), 32);
+  data[0] = 4;
+  EXPECT_EQ(std::as_const(owned).Determinant(), 64);
+  EXPECT_EQ(std::as_const(owned).InverseMatrix()(0, 0), 0.25);
+
+  EXPECT_THROW(S21Matrix::View(buffer, 2, 3, 2), std::invalid_argument);
+  EXPECT_THROW(S21Matrix::View(static_cast<double*>(nullptr), 1, 1),
+               std::invalid_argument);
+}
+
+TEST(MatrixTest, ElementIterators) {
+  double buffer[] = {3, 1, 0, 2, 5, 0, 4, 6, 0};
+  S21Matrix view = S21Matrix::View(buffer, 3, 2, 3);
+  EXPECT_EQ(view.end() - view.begin(), 6);
+  EXPECT_EQ(std::accumulate(view.cbegin(), view.cend(), 0.0), 21);
+
+  // Сортировка по всем элементам не трогает шаг строки
+  std::sort(view.begin(), view.end());
+  const double sorted[] = {1, 2, 0, 3, 4, 0, 5, 6, 0};
+  EXPECT_TRUE(std::equal(buffer, buffer + 9, sorted));
+
+  const S21Matrix& constant = view;
+  auto it = constant.begin() + 5;
+  EXPECT_EQ(*it, 6);
+  EXPECT_EQ(it[-3], 3);
+  EXPECT_EQ(*--it, 5);
+  EXPECT_TRUE(view.begin() < it);
+  EXPECT_EQ(*std::ranges::max_element(constant), 6);
+  static_assert(std::random_access_iterator<S21Matrix::iterator>);
+  static_assert(std::ranges::random_access_range<const S21Matrix>);
+
+  // Копирование при записи отделяет буфер до выдачи итераторов
+  S21Matrix a(4, 5);
+  a.SetCopyOnWrite(true);
+  S21Matrix b = a;
+  std::iota(b.begin(), b.end(), 0.0);
+  EXPECT_EQ(a(3, 4), 0);
+  EXPECT_EQ(b(3, 4), 19);
+
+  S21Matrix empty;
+  EXPECT_TRUE(empty.begin() == empty.end());
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();